@@ -0,0 +1,205 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::benchmark
+{
+	// Results of a single benchmark scenario.
+	class Measurement
+	{
+	public:
+		// Time spent on all the operations.
+		double Seconds;
+
+		// Count of page protection changes made during the scenario.
+		size_t ProtectionChanges;
+
+		// Count of heap lock acquisitions that had to wait for another thread during the scenario.
+		size_t ContendedLocks;
+
+		// Resident memory of the process after the scenario.
+		size_t ResidentKilobytes;
+	};
+
+	// Reads the resident memory of the process (zero where it is not known).
+	static size_t GetResidentKilobytes()
+	{
+#ifdef __unix__
+		ifstream statm("/proc/self/statm");
+		size_t totalPages = 0;
+		size_t residentPages = 0;
+		statm >> totalPages >> residentPages;
+		return residentPages * (MemoryProtector::GetMemoryPageSize() / 1024);
+#else
+		return 0;
+#endif
+	};
+
+	// Runs the scenario once and collects its results.
+	static Measurement Measure(const function<void()>& scenario)
+	{
+		auto before = ImmutableStatistics::Collect();
+		auto start = chrono::steady_clock::now();
+		scenario();
+		auto finish = chrono::steady_clock::now();
+		auto after = ImmutableStatistics::Collect();
+		Measurement result;
+		result.Seconds = chrono::duration<double>(finish - start).count();
+		result.ProtectionChanges = (after.ProtectCalls + after.UnprotectCalls) - (before.ProtectCalls + before.UnprotectCalls);
+		result.ContendedLocks = after.ContendedLockAcquisitions - before.ContendedLockAcquisitions;
+		result.ResidentKilobytes = GetResidentKilobytes();
+		return result;
+	};
+
+	// Prints the results of the scenario as a table row.
+	static void Report(const char* name, size_t operations, const Measurement& measurement)
+	{
+		auto nanosecondsPerOperation = measurement.Seconds * 1e9 / operations;
+		auto millionsPerSecond = operations / measurement.Seconds / 1e6;
+		printf("%-32s %12zu %12.1f %12.2f %14zu %12zu %12zu\n", name, operations, nanosecondsPerOperation, millionsPerSecond, measurement.ProtectionChanges, measurement.ContendedLocks, measurement.ResidentKilobytes);
+	};
+
+	// Latency of every allocator operation on its own, measured over a large number of objects.
+	static void BenchmarkOperations(size_t count)
+	{
+		vector<int*> objects(count);
+		auto allocation = Measure([&]()
+		{
+			for (auto& object : objects)
+				object = ImmutableAllocator<int>::allocate(1);
+		});
+		Report("allocate", count, allocation);
+		auto construction = Measure([&]()
+		{
+			for (auto object : objects)
+				ImmutableAllocator<int>::construct(object, 1);
+		});
+		Report("construct", count, construction);
+		auto destruction = Measure([&]()
+		{
+			for (auto object : objects)
+				ImmutableAllocator<int>::destroy(object);
+		});
+		Report("destroy", count, destruction);
+		auto deallocation = Measure([&]()
+		{
+			for (auto object : objects)
+				ImmutableAllocator<int>::deallocate(object, 1);
+		});
+		Report("deallocate", count, deallocation);
+		ImmutableRegion region;
+		auto creation = Measure([&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+				region.Create<int>(1);
+		});
+		Report("region create", count, creation);
+		auto release = Measure([&]() { region.Release(); });
+		Report("region release", count, release);
+		auto batchCreation = Measure([&]()
+		{
+			ImmutableBatch batch;
+			for (size_t i = 0; i < count; ++i)
+				region.Create<int>(1);
+		});
+		Report("region create, batch", count, batchCreation);
+		region.Release();
+	};
+
+	// Creates and removes objects one by one, as short-lived immutable values do.
+	template<class Allocator = ImmutableAllocator<size_t>> static void ChurnObjects(size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto object = Allocator::allocate(1);
+			Allocator::construct(object, i);
+			Allocator::destroy(object);
+			Allocator::deallocate(object, 1);
+		}
+	};
+
+	// Throughput of the whole object life cycle on one thread and on several threads at once.
+	static void BenchmarkThroughput(size_t count, size_t threadsCount)
+	{
+		auto single = Measure([&]() { ChurnObjects(count); });
+		Report("life cycle, 1 thread", count, single);
+		auto confined = Measure([&]() { ChurnObjects<ImmutableConfinedAllocator<size_t>>(count); });
+		Report("life cycle, confined", count, confined);
+		auto softSealed = Measure([&]() { ChurnObjects<ImmutableSoftSealedAllocator<size_t>>(count); });
+		Report("life cycle, soft sealed", count, softSealed);
+		auto multiple = Measure([&]()
+		{
+			vector<thread> threads;
+			for (size_t i = 0; i < threadsCount; ++i)
+				threads.emplace_back(ChurnObjects<>, count);
+			for (auto& worker : threads)
+				worker.join();
+		});
+		char name[64];
+		snprintf(name, sizeof(name), "life cycle, %zu threads", threadsCount);
+		Report(name, count * threadsCount, multiple);
+	};
+
+	// Filling of containers, element by element and in one pass.
+	static void BenchmarkContainers(size_t count)
+	{
+		auto pushing = Measure([&]()
+		{
+			vector<int, ImmutableAllocator<int>> values;
+			for (size_t i = 0; i < count; ++i)
+				values.push_back((int)i);
+		});
+		Report("vector push_back", count, pushing);
+		auto batching = Measure([&]()
+		{
+			ImmutableBatch batch;
+			vector<int, ImmutableAllocator<int>> values;
+			for (size_t i = 0; i < count; ++i)
+				values.push_back((int)i);
+		});
+		Report("vector push_back in batch", count, batching);
+		vector<int> source(count, 1);
+		auto freezing = Measure([&]() { FrozenVector<int> values(source.begin(), source.end()); });
+		Report("frozen vector fill", count, freezing);
+	};
+
+	// Reading of sealed pages, which should be as fast as reading any other memory.
+	static void BenchmarkReading(size_t count, size_t passes)
+	{
+		vector<size_t> source(count, 1);
+		FrozenVector<size_t> values(source.begin(), source.end());
+		volatile size_t total = 0;
+		auto reading = Measure([&]()
+		{
+			for (size_t pass = 0; pass < passes; ++pass)
+			{
+				size_t sum = 0;
+				for (auto value : values)
+					sum += value;
+				total = total + sum;
+			}
+		});
+		Report("sealed pages read", count * passes, reading);
+	};
+};
+
+int main(int argc, char** argv)
+{
+	using namespace immutable::benchmark;
+	// a quick run only checks that every scenario works
+	auto isQuick = argc > 1 && string(argv[1]) == "--quick";
+	size_t count = isQuick ? 10000 : 100000;
+	auto threadsCount = max<size_t>(2, thread::hardware_concurrency());
+	printf("%-32s %12s %12s %12s %14s %12s %12s\n", "scenario", "operations", "ns/op", "Mops/s", "protections", "contended", "rss KiB");
+	BenchmarkOperations(count);
+	BenchmarkThroughput(count, threadsCount);
+	BenchmarkContainers(count);
+	BenchmarkReading(count, isQuick ? 10 : 100);
+	auto statistics = immutable::ImmutableStatistics::Collect();
+	printf("\nlive pages %zu, live blocks %zu, live bytes %zu, wasted tail bytes %zu, map calls %zu, unmap calls %zu\n", statistics.LivePages, statistics.LiveBlocks, statistics.LiveBytes, statistics.WastedTailBytes, statistics.MapCalls, statistics.UnmapCalls);
+	return 0;
+};
\ No newline at end of file
@@ -3,46 +3,205 @@
 #include <iostream>
 #include <list>
 #include <mutex>
+#include <shared_mutex>
 #include <memory>
-#include <map>
+#include <algorithm>
+#include <unordered_set>
+#include <unordered_map>
+#include <initializer_list>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <bit>
+#include <functional>
+#include <new>
+#include <numeric>
+#include <thread>
+#include <memory_resource>
 
-#ifdef __unix__
-#include "internals\protectors\memory_protector_unix.h"
-using MemoryProtector = immutable::internals::protectors::MemoryProtectorUnix MemoryProtector;
+#if defined(__linux__) && defined(IMMUTABLE_DUAL_MAPPING)
+#include "internals/protectors/memory_protector_dual.h"
+using MemoryProtector = immutable::internals::protectors::MemoryProtectorDual;
+using PlatformMemoryProtector = immutable::internals::protectors::MemoryProtectorUnix;
+#elif defined(__unix__)
+#include "internals/protectors/memory_protector_unix.h"
+using MemoryProtector = immutable::internals::protectors::MemoryProtectorUnix;
+using PlatformMemoryProtector = MemoryProtector;
 #elif defined(_WIN32)
-#include "internals\protectors\memory_protector_windows.h"
+#include "internals/protectors/memory_protector_windows.h"
 using MemoryProtector = immutable::internals::protectors::MemoryProtectorWindows;
+using PlatformMemoryProtector = MemoryProtector;
 #else
 // If you want to expand functionality for the new platform, you can add your memory proitector declaration here!
 #error You must define at least one of the tokens __unix__ or _WIN32.
 #endif
 
-#include "internals\memory_block.h"
-#include "internals\memory_page.h"
+#include "internals/protectors/memory_protector_soft.h"
+using SoftMemoryProtector = immutable::internals::protectors::MemoryProtectorSoft;
+
+#include "internals/memory_page.h"
+#include "internals/memory_heap.h"
+#include "internals/memory_arena.h"
+#include "internals/heap_statistics.h"
+#include "internals/persistent_node.h"
+#include "internals/epoch_domain.h"
+#include "internals/page_codec.h"
+#include "internals/trace_recorder.h"
 
 using namespace immutable::internals;
 using namespace std;
 
 namespace immutable
 {
+	class ImmutableBatch;
+
+	class ImmutableRegion;
+
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> class BasicImmutableAllocator;
+
+	template<class T> class ImmutableSharedPtr;
+
+	// Events of the immutable heap that can be watched through a hook.
+	enum class ImmutableEvent
+	{
+		// A page was taken from the system.
+		PageCaught,
+
+		// A page was returned to the system.
+		PageFreed,
+
+		// A page was closed for writing.
+		PageLocked,
+
+		// A page was opened for writing.
+		PageUnlocked
+	};
+
+	// A function called on every event with the address and the size of the affected memory (it must not use the allocator itself).
+	using ImmutableEventHook = void(*)(ImmutableEvent event, void* address, size_t size);
+
 	// Storage for memory allocation internal data.
 	class ImmutableData
 	{
 	private:
 		// Let him have access to storage for memory allocation data.
-		template<class T> friend class ImmutableAllocator;
+		template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> friend class BasicImmutableAllocator;
+
+		// Let him have access to storage for handing out the default pages.
+		friend class ImmutableGlobalPageSource;
+
+		// Let him have access to storage for registering himself on the thread.
+		friend class ImmutableBatch;
+
+		// Let him have access to storage for setting the event hook.
+		friend class ImmutableStatistics;
+
+		// Let him have access to storage for filling the heap with pages in advance.
+		friend class ImmutablePool;
+
+		// Let him have access to storage for marking the thread as reading.
+		friend class ImmutableReader;
+
+		// Let him have access to storage for queueing objects for deferred destruction.
+		friend class ImmutableEpoch;
+
+		// Let him have access to storage for finding the pages of faulting addresses.
+		friend class ImmutableColdPages;
+
+		// Let him have access to storage for keeping his pages open in the batch of the thread.
+		friend class ImmutableRegion;
+
+#ifdef IMMUTABLE_HUGE_PAGES
+		// Size of the pages the allocator locks and unlocks (huge pages for large immutable data sets).
+		static inline size_t PageSize = MemoryProtector::GetHugeMemoryPageSize();
+#else
+		// Size of the pages the allocator locks and unlocks (operating system pages by default).
+		static inline size_t PageSize = MemoryProtector::GetMemoryPageSize();
+#endif
+
+		// Size of the processor cache line the allocator can place blocks within.
+		static constexpr size_t CacheLineSize = 64;
+
+		// The largest single block rounded up to a size class (larger blocks take pages of their exact size).
+		static constexpr size_t LargestSizeClass = 1024;
+
+		// Count of cached pages searched for a run of several free slots before a new page is taken.
+		static constexpr size_t ScannedPagesLimit = 8;
+
+		// Size of the address region reserved for all allocator-managed memory pages (only addresses, not memory).
+		static constexpr size_t ArenaSize = (sizeof(void*) == 8) ? ((size_t)16 << 30) : ((size_t)256 << 20);
 
-		// An object for synchronizing work with an allocator (someday the synchronization will be rewritten).
-		static inline mutex Mutex;
+		// The address region of all allocator-managed memory pages with a table for searching pages by address.
+		static inline MemoryArena Arena = MemoryArena(MemoryProtector::ReserveRegion(ArenaSize, PageSize), ArenaSize, PageSize);
 
-		// Operating system memory page size.
-		static inline size_t SystemPageSize = MemoryProtector::GetMemoryPageSize();
+		// Heaps of the threads allocating from the region of all allocator-managed memory pages.
+		static inline MemoryHeapPool HeapPool;
 
-		// Allocator-managed memory pages, in order of increasing free space on the page.
-		static inline list<MemoryPage*> MemoryPages;
+		// The heap of the current thread with its own pages and blocks.
+		static inline thread_local MemoryHeapLease ThreadHeap = MemoryHeapLease(HeapPool);
 
-		// Allocator-managed memory blocks with no ordering.
-		static inline map<void*, MemoryBlock*> MemoryBlocks;
+		// The innermost batch of the current thread (null if there is no batch).
+		static inline thread_local ImmutableBatch* ThreadBatch = nullptr;
+
+		// The function watching the events of the immutable heap (null if no one is watching).
+		static inline atomic<ImmutableEventHook> EventHook = nullptr;
+
+		// Total size of the empty pages every heap may keep for new allocations instead of returning them to the system.
+		static inline atomic<size_t> RetainedSizeLimit = (size_t)4 << 20;
+
+		// The domain of objects retired by all threads and waiting for their readers to leave.
+		static inline EpochDomain Epochs;
+	};
+
+	// A lock policy for heaps confined to a single thread, which takes no lock at all (objects must never be touched by other threads).
+	class ImmutableNullLock
+	{
+	public:
+		// Takes nothing, so that the policy compiles away.
+		ImmutableNullLock(MemoryHeap*) {};
+	};
+
+	// A page source policy handing out pages of the single region shared by all allocators with default policies.
+	class ImmutableGlobalPageSource
+	{
+	public:
+		// For checking that the allocator protects the pages the same way as they were reserved.
+		using ProtectPolicy = MemoryProtector;
+
+		// The region of the pages with a table for searching pages by address.
+		static MemoryArena& GetArena();
+
+		// The heap of the current thread.
+		static MemoryHeap* GetThreadHeap();
+
+		// Size of the pages the allocator locks and unlocks.
+		static size_t GetPageSize();
+	};
+
+	// A page source policy with its own region and heaps, one instance per tag type (the protector must not have a writable alias, since it maps a single region).
+	template<class Tag, class Protector = PlatformMemoryProtector, size_t RegionSize = ((size_t)1 << 30)> class ImmutableIsolatedPageSource
+	{
+	public:
+		// For checking that the allocator protects the pages the same way as they were reserved.
+		using ProtectPolicy = Protector;
+
+		// The region of the pages with a table for searching pages by address.
+		static MemoryArena& GetArena();
+
+		// The heap of the current thread (kept for another thread of the source when the thread ends, since its objects may outlive the thread).
+		static MemoryHeap* GetThreadHeap();
+
+		// Size of the pages the allocator locks and unlocks.
+		static size_t GetPageSize();
 	};
 
 	// A wrapper for pinning an immutable object to the local scope.
@@ -62,22 +221,50 @@ namespace immutable
 		~ImmutableGuard();
 	};
 
-	// Memory allocator for immutable objects.
-	template<class T> class ImmutableAllocator
+#ifdef __cpp_lib_allocate_at_least
+	// Memory returned by allocate_at_least with the count of objects that actually fit into it.
+	template<class T> using ImmutableAllocationResult = allocation_result<T*>;
+#else
+	// Memory returned by allocate_at_least with the count of objects that actually fit into it (the same as the one of std since C++23).
+	template<class T> class ImmutableAllocationResult
+	{
+	public:
+		// The allocated memory.
+		T* ptr;
+
+		// Count of objects that fit into the memory.
+		size_t count;
+	};
+#endif
+
+	// Memory allocator for immutable objects, whose locking, protection and source of pages are chosen at compile time.
+	template<class T, class LockPolicy = MemoryHeapLock, class ProtectPolicy = MemoryProtector, class PageSourcePolicy = ImmutableGlobalPageSource> class BasicImmutableAllocator
 	{
 	public:
 		// For some reason, this typedef is required.
 		using value_type = T;
 
 		// Filling static fields in the case of a default constructor.
-		ImmutableAllocator() {};
+		BasicImmutableAllocator() {};
 
 		// Filling static fields in the case of a copy constructor.
-		template<class U> ImmutableAllocator(const ImmutableAllocator<U>& other) {};
+		template<class U> BasicImmutableAllocator(const BasicImmutableAllocator<U, LockPolicy, ProtectPolicy, PageSourcePolicy>& other) {};
 
 		// Interface method for allocating memory for an allocator trait from std.
 		static T* allocate(size_t count_objects);
 
+		// Allocates memory starting at the given alignment (a power of two no larger than the page, such as for SIMD loads).
+		static T* allocate(size_t count_objects, align_val_t alignment);
+
+		// Allocates memory that does not cross a cache line if it fits into one, or else starts at a cache line.
+		static T* AllocateInCacheLine(size_t count_objects);
+
+		// Interface method for allocating memory for an allocator trait from std, giving the whole pages to objects that take more than a page.
+		static ImmutableAllocationResult<T> allocate_at_least(size_t count_objects);
+
+		// Grows the memory of plain objects to the larger count without constructing them again: in place if the addresses after it are unused, by moving its pages if it occupies them alone, otherwise by copying. Returns the new address.
+		static T* Reallocate(T* ptr, size_t count_objects, size_t new_count_objects);
+
 		// Interface method for initializing an object for an allocator trait from std.
 		template<class U, class... Args> static void construct(U* p, Args&&... args);
 
@@ -87,26 +274,1088 @@ namespace immutable
 		// Interface method for freeing memory for the allocator trait from std.
 		static void deallocate(T* ptr, size_t count_objects);
 
+		// Checks the sealed pages of the current thread against their checksums. Returns count of changed pages (always zero if the protector keeps no checksums).
+		static size_t VerifySealedPages();
+
+		// Initializes a sequence of objects with the same arguments, opening their page for writing only once.
+		template<class U, class... Args> static void construct_n(U* p, size_t count_objects, Args&&... args);
+
+		// Deinitializes a sequence of objects, opening their page for writing only once.
+		template<class U> static void destroy_n(U* p, size_t count_objects);
+
 	private:
-		// Takes a free block of memory from an existing page (or creates a new one for this purpose).
-		static MemoryBlock* CatchBlocksAndReturnFirst(size_t blockSize, size_t blockCount);
+		// Takes free blocks of memory from an existing page of the heap (or creates a new one for this purpose) and returns the address of the first one.
+		static void* CatchBlocksAndReturnFirst(MemoryHeap* heap, size_t blockSize, size_t blockCount, size_t alignment);
+
+		// The size of the slots holding the blocks: single blocks are rounded up to a size class, so that types of close sizes share pages, while a sequence of blocks needs slots of its exact size.
+		static constexpr size_t GetSlotSize(size_t blockSize, size_t blockCount);
+
+		// Grows the blocks occupying the page alone by growing the page itself. If success returns the new address of the blocks else returns null.
+		static T* GrowMemoryPage(MemoryHeap* heap, MemoryPage* page, size_t blockCount, size_t newBlockCount);
 
 		// Releases the memory blocks on the page and the page itself if it is empty.
-		static void FreeBlocks(void* startAddress, size_t blockSize, size_t blockCount);
+		static void FreeBlocks(MemoryPage* page, void* startAddress, size_t blockSize, size_t blockCount);
+
+		// Frees the blocks that other threads have released into the queue of the heap.
+		static void FreeRemoteReleases(MemoryHeap* heap);
+
+		// Pages must be protected the same way as they were reserved.
+		static_assert(is_same_v<ProtectPolicy, typename PageSourcePolicy::ProtectPolicy>, "The protect policy does not match the page source.");
 
 		// Let him have access to internal methods just in case.
 		friend class ImmutableGuard<T>;
 
-		// Looks for a memory page with enough free space. If success returns page position in cache else return end position.
-		static list<MemoryPage*>::iterator FindMemoryPagePositionWithEnoughSpace(size_t minFreeSpace);
+		// Let him have access to internal methods for sealing pages.
+		friend class ImmutableBatch;
+
+		// Let him have access to internal methods for filling the heap with pages in advance.
+		friend class ImmutablePool;
+
+		// Let him have access to the counters of references to shared objects.
+		template<class U> friend class ImmutableSharedPtr;
+
+		// Let him make the counters of references to the objects he has created.
+		template<class U, class... Args> friend ImmutableSharedPtr<U> MakeImmutableShared(Args&&... args);
+
+		// Let him have access to the counters of references to the nodes.
+		template<class U> friend class PersistentVector;
+
+		// Let him have access to the counters of references to the nodes.
+		template<class K, class V, class Hash> friend class PersistentMap;
+
+		// Makes the counter of references to the shared object kept aside from its sealed page, set to a single reference.
+		static atomic<size_t>* CreateReferenceCount(T* object);
+
+		// Drops the counter of references to the object no longer referenced by anyone.
+		static void ReleaseReferenceCount(T* object);
+
+		// Opens the page for writing if no one else keeps it open.
+		static void OpenPage(MemoryPage* page);
+
+		// Closes the page for writing if no one else keeps it open, and frees the page if it is empty.
+		static void ClosePage(MemoryPage* page);
+
+		// Leaves the page open in the batch of the thread if there is one, otherwise closes it.
+		static void ClosePageOrKeepInBatch(MemoryPage* page);
+
+		// Keeps the empty page for new allocations if the heap has room for it, otherwise returns it to the system.
+		static void FreeMemoryPage(MemoryPage* page);
+
+		// Returns the empty page to the system.
+		static void ReturnMemoryPage(MemoryPage* page);
+
+		// Takes a retained page of the size from the heap. If success returns page else returns null.
+		static MemoryPage* TakeRetainedPage(MemoryHeap* heap, size_t pageSize);
+
+		// Searches for the memory page containing the specified address. If success returns page else throws an exception.
+		static MemoryPage* FindMemoryPage(void* address);
+
+		// Searches for a memory blocks sequence by first block starting address. If success returns first slot number else throws an exception.
+		static size_t FindMemoryBlocksAndReturnFirstSlot(MemoryPage* page, void* startAddress, size_t blockSize, size_t blockCount);
+
+		// Inserts a page into the heap list of pages with free slots of the same size.
+		static void InsertMemoryPageInCache(MemoryHeap* heap, MemoryPage* page);
+
+		// Removes a page from the heap list of pages with free slots of the same size.
+		static void RemoveMemoryPageFromCache(MemoryHeap* heap, MemoryPage* page);
+
+		// Passes the event about the page to the hook if there is one.
+		static void RaiseEvent(ImmutableEvent event, MemoryPage* page);
+
+		// Passes the call to the trace if it is recording.
+		static void RecordCall(TraceOperation operation, const void* address, size_t size, size_t count);
+	};
+
+	// Memory allocator for immutable objects with the default policies.
+	template<class T> class ImmutableAllocator : public BasicImmutableAllocator<T>
+	{
+	public:
+		// Filling static fields in the case of a default constructor.
+		ImmutableAllocator() {};
+
+		// Filling static fields in the case of a copy constructor.
+		template<class U> ImmutableAllocator(const ImmutableAllocator<U>& other) {};
+	};
+
+	// A tag of the region of the confined allocator.
+	class ImmutableConfinedRegion
+	{
+	};
+
+	// Memory allocator for objects that never leave their thread, so that it takes no locks at all.
+	template<class T> using ImmutableConfinedAllocator = BasicImmutableAllocator<T, ImmutableNullLock, PlatformMemoryProtector, ImmutableIsolatedPageSource<ImmutableConfinedRegion>>;
+
+	// Memory allocator sealing pages with checksums instead of the hardware, for tiny objects constructed too often to pay for changing the protection (a write to a sealed object is found by checking, not by a fault).
+	template<class T> using ImmutableSoftSealedAllocator = BasicImmutableAllocator<T, MemoryHeapLock, SoftMemoryProtector, ImmutableIsolatedPageSource<SoftMemoryProtector, SoftMemoryProtector>>;
+
+	// A scope in which the pages of constructed and destroyed objects are opened for writing once and sealed together.
+	class ImmutableBatch
+	{
+	public:
+		// Makes the batch the current one for the thread.
+		ImmutableBatch();
+
+		// Seals the pages of the batch and restores the previous batch of the thread.
+		~ImmutableBatch();
+
+		// The batch is bound to the thread and its pages, so it cannot be copied.
+		ImmutableBatch(const ImmutableBatch&) = delete;
+
+		// The batch is bound to the thread and its pages, so it cannot be assigned.
+		ImmutableBatch& operator=(const ImmutableBatch&) = delete;
+
+		// Seals all the pages opened within the batch so far.
+		void Commit();
+
+	private:
+		// Let him have access to the pages of the batch.
+		template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> friend class BasicImmutableAllocator;
+
+		// Let him have access to the regions of the batch.
+		friend class ImmutableRegion;
+
+		// The batch that was current for the thread before this one.
+		ImmutableBatch* PreviousBatch;
+
+		// Pages kept open for writing until the batch is committed.
+		unordered_set<MemoryPage*> OpenedPages;
+
+		// Regions keeping their pages open for writing until the batch is committed.
+		unordered_set<ImmutableRegion*> OpenedRegions;
+	};
+
+	// An immutable array of exactly the required size, filled from mutable memory in one pass.
+	template<class T> class FrozenVector
+	{
+	public:
+		// For compatibility with algorithms from std.
+		using value_type = T;
+
+		// Read-only access to the elements is the only one possible.
+		using const_iterator = const T*;
+
+		// A constructor of an empty array that takes no memory.
+		FrozenVector();
+
+		// A constructor that copies a range of known size into immutable memory.
+		template<class ForwardIt> FrozenVector(ForwardIt first, ForwardIt last);
+
+		// A constructor that copies the listed values into immutable memory.
+		FrozenVector(initializer_list<T> values);
+
+		// A constructor that moves the elements of a mutable vector into immutable memory.
+		FrozenVector(vector<T>&& values);
+
+		// A constructor that copies the elements of another immutable array.
+		FrozenVector(const FrozenVector& other);
+
+		// A constructor that takes the elements of another immutable array without copying.
+		FrozenVector(FrozenVector&& other) noexcept;
+
+		// Replaces the elements with the elements of another immutable array.
+		FrozenVector& operator=(FrozenVector other) noexcept;
+
+		// It will properly clean up after the elements when the array is destroyed.
+		~FrozenVector();
+
+		// Access to the contiguous elements.
+		const T* data() const;
+
+		// Count of the elements.
+		size_t size() const;
+
+		// A sign that there are no elements.
+		bool empty() const;
+
+		// Access to the element by its number.
+		const T& operator[](size_t index) const;
+
+		// The position of the first element.
+		const_iterator begin() const;
+
+		// The position after the last element.
+		const_iterator end() const;
+
+		// A read-only view of the elements.
+		operator span<const T>() const;
+
+	private:
+		// The elements located in immutable memory.
+		T* Elements;
+
+		// Count of the elements.
+		size_t Count;
+
+		// Initializes the elements from a range, opening the page for writing only once.
+		template<class ForwardIt> void FreezeElements(ForwardIt first);
+	};
+
+	// An immutable null-terminated string of exactly the required size.
+	class FrozenString
+	{
+	public:
+		// A constructor of an empty string.
+		FrozenString();
+
+		// A constructor that copies the characters into immutable memory.
+		FrozenString(string_view value);
+
+		// Access to the contiguous characters.
+		const char* data() const;
+
+		// Access to the null-terminated characters.
+		const char* c_str() const;
+
+		// Count of the characters without the terminating null.
+		size_t size() const;
+
+		// A sign that there are no characters.
+		bool empty() const;
+
+		// Access to the character by its number.
+		const char& operator[](size_t index) const;
+
+		// The position of the first character.
+		const char* begin() const;
+
+		// The position after the last character.
+		const char* end() const;
+
+		// A read-only view of the characters.
+		operator string_view() const;
+
+		// A sign that the characters are equal to the given ones.
+		bool operator==(string_view other) const;
+
+	private:
+		// A walk over the characters of a view followed by the terminating null, so they are frozen without an intermediate buffer.
+		class TerminatedIterator
+		{
+		public:
+			// For compatibility with algorithms from std.
+			using iterator_category = forward_iterator_tag;
+			using value_type = char;
+			using difference_type = ptrdiff_t;
+			using pointer = const char*;
+			using reference = const char&;
+
+			// A constructor of the position of the given character, where the position after the view is the terminating null.
+			TerminatedIterator(string_view value, size_t index);
+
+			// The character at the position.
+			const char& operator*() const;
+
+			// Moves to the next character.
+			TerminatedIterator& operator++();
+
+			// Moves to the next character and returns the previous position.
+			TerminatedIterator operator++(int);
+
+			// A sign that both positions are the same.
+			bool operator==(const TerminatedIterator& other) const;
+
+		private:
+			// The characters without the terminating null.
+			string_view Value;
+
+			// Number of the current character.
+			size_t Index;
+		};
+
+		// The characters with the terminating null (empty only for an empty string).
+		FrozenVector<char> Characters;
+	};
+
+	// Empty pages kept by the heap of every thread, so that allocations in a steady state need no calls to the system.
+	class ImmutablePool
+	{
+	public:
+		// Takes pages with memory already behind them from the system and keeps them in the heap of the current thread, as far as the retained size limit allows.
+		static void Reserve(size_t bytes);
+
+		// Lets the system take the memory of the pages kept by the current thread when it runs short, without giving up the pages.
+		static void Trim();
+
+		// Sets the total size of the empty pages every heap may keep after their blocks are freed.
+		static void SetRetainedSizeLimit(size_t bytes);
+	};
+
+	// Summary of the immutable heaps of all threads, collected from their own counters at the time of reading.
+	class ImmutableStatistics
+	{
+	public:
+		// Count of pages taken from the system and not yet returned.
+		size_t LivePages;
+
+		// Count of allocated blocks.
+		size_t LiveBlocks;
+
+		// Size of allocated blocks.
+		size_t LiveBytes;
+
+		// Count of empty pages kept for new allocations.
+		size_t RetainedPages;
+
+		// Size of the page tails that are too short for another slot.
+		size_t WastedTailBytes;
+
+		// Count of calls closing pages for writing.
+		size_t ProtectCalls;
+
+		// Count of calls opening pages for writing.
+		size_t UnprotectCalls;
+
+		// Count of calls taking pages from the system.
+		size_t MapCalls;
+
+		// Count of calls returning pages to the system.
+		size_t UnmapCalls;
+
+		// Count of exclusive heap lock acquisitions.
+		size_t LockAcquisitions;
+
+		// Count of exclusive heap lock acquisitions that had to wait for another thread.
+		size_t ContendedLockAcquisitions;
+
+		// Time spent waiting for heap locks.
+		size_t LockWaitNanoseconds;
+
+		// Time heap locks were held (only counted while lock timing is enabled).
+		size_t LockHoldNanoseconds;
+
+		// Count of allocations by size, where the bucket N holds sizes from 2^(N-1) to 2^N - 1 bytes.
+		array<size_t, HeapStatistics::HistogramSize> AllocationSizeHistogram;
+
+		// Sums up the counters of all heaps.
+		static ImmutableStatistics Collect();
+
+		// Turns on or off counting the time heap locks are held.
+		static void EnableLockTiming(bool isEnabled);
+
+		// Sets the function watching the events of the immutable heap (null to stop watching).
+		static void SetEventHook(ImmutableEventHook hook);
+	};
+
+	// A pointer stored as a distance from itself, so it stays valid wherever the snapshot is mapped.
+	template<class T> class SnapshotPointer
+	{
+	public:
+		// Access to the pointed objects (null if the pointer is empty).
+		const T* get() const;
+
+		// Access to the pointed object.
+		const T& operator*() const;
+
+		// Access to the members of the pointed object.
+		const T* operator->() const;
+
+		// Access to the pointed object by its number.
+		const T& operator[](size_t index) const;
+
+		// A sign that the pointer is not empty.
+		explicit operator bool() const;
+
+	private:
+		// Let him have access to the distance for linking the objects of the snapshot.
+		friend class ImmutableSnapshotBuilder;
+
+		// Distance in bytes from the pointer to the pointed objects (zero for an empty pointer).
+		ptrdiff_t Offset = 0;
+	};
+
+	// A read-only snapshot file mapped into memory without copying, whose pages are shared by processes through the page cache.
+	class ImmutableSnapshot
+	{
+	public:
+		// Maps the snapshot file into memory and checks its header.
+		ImmutableSnapshot(const string& path);
+
+#ifdef __linux__
+		// Maps the sealed shared memory made by a snapshot builder into memory and checks its header (the descriptor may be closed after that).
+		ImmutableSnapshot(int sharedMemory);
+#endif
+
+		// Removes the mapping of the snapshot file.
+		~ImmutableSnapshot();
+
+		// The snapshot owns its mapping, so it cannot be copied.
+		ImmutableSnapshot(const ImmutableSnapshot&) = delete;
+
+		// The snapshot owns its mapping, so it cannot be assigned.
+		ImmutableSnapshot& operator=(const ImmutableSnapshot&) = delete;
+
+		// Access to the object the snapshot was built around.
+		template<class T> const T* Root() const;
+
+		// Access to the objects at the offset from the beginning of the snapshot.
+		template<class T> const T* View(size_t offset, size_t count_objects = 1) const;
+
+		// Size of the snapshot file.
+		size_t size() const;
+
+#ifdef __unix__
+		// Passes the shared memory of a snapshot to the process on the other side of the local socket.
+		static void SendSharedMemory(int socket, int sharedMemory);
+
+		// Takes the shared memory of a snapshot passed by the process on the other side of the local socket.
+		static int ReceiveSharedMemory(int socket);
+#endif
+
+	private:
+		// Let him have access to the header layout for writing snapshots.
+		friend class ImmutableSnapshotBuilder;
+
+		// Information at the beginning of every snapshot file.
+		class Header
+		{
+		public:
+			// A mark of the snapshot file format.
+			uint64_t Signature;
+
+			// A version of the snapshot file format.
+			uint64_t Version;
+
+			// Size of the snapshot file.
+			uint64_t TotalSize;
+
+			// Offset of the root object from the beginning of the snapshot.
+			uint64_t RootOffset;
+		};
+
+		// A mark of the snapshot file format ("IMMSNAP" with a terminating null).
+		static constexpr uint64_t FormatSignature = 0x0050414E534D4D49;
+
+		// A version of the snapshot file format.
+		static constexpr uint64_t FormatVersion = 1;
+
+		// Address of the mapped snapshot file.
+		const char* StartAddress;
+
+		// Size of the mapped snapshot file.
+		size_t TotalSize;
+
+		// Checks the header of the mapped snapshot and removes the mapping if it is corrupted.
+		void CheckHeader();
+	};
+
+	// Lays out plain objects one after another with offset-based pointers between them and writes them as a snapshot file.
+	class ImmutableSnapshotBuilder
+	{
+	public:
+		// A constructor of a snapshot with only a header.
+		ImmutableSnapshotBuilder();
+
+		// Copies a sequence of plain objects into the snapshot and returns the offset of the first one.
+		template<class T> size_t Append(const T* values, size_t count_objects);
+
+		// Copies a plain object into the snapshot and returns its offset.
+		template<class T> size_t Append(const T& value);
+
+		// Makes the pointer at one offset of the snapshot point to the objects at another offset.
+		template<class T> void Link(size_t pointerOffset, size_t targetOffset);
+
+		// Sets the object the snapshot is built around.
+		void SetRoot(size_t rootOffset);
+
+		// Writes the snapshot to the file.
+		void Save(const string& path) const;
+
+#ifdef __linux__
+		// Writes the snapshot to sealed shared memory, which other processes can map but no one can change (the caller closes the descriptor).
+		int Share() const;
+#endif
+
+	private:
+		// The snapshot contents starting with the header.
+		vector<char> Buffer;
+
+		// Offset of the root object from the beginning of the snapshot.
+		size_t RootOffset;
+
+		// The snapshot contents with the filled header.
+		vector<char> Seal() const;
+	};
+
+	// Shared ownership of an immutable object, whose counter of references lies in the writable information of its page instead of a separate block.
+	template<class T> class ImmutableSharedPtr
+	{
+	public:
+		// For compatibility with smart pointers from std.
+		using element_type = T;
+
+		// A constructor of a pointer that owns nothing.
+		ImmutableSharedPtr();
+
+		// A constructor that shares the object of another pointer.
+		ImmutableSharedPtr(const ImmutableSharedPtr& other);
+
+		// A constructor that takes the object of another pointer.
+		ImmutableSharedPtr(ImmutableSharedPtr&& other) noexcept;
+
+		// Replaces the owned object with the object of another pointer.
+		ImmutableSharedPtr& operator=(ImmutableSharedPtr other) noexcept;
+
+		// Destroys the object when the last pointer to it is destroyed.
+		~ImmutableSharedPtr();
+
+		// Access to the object.
+		const T* get() const;
+
+		// Access to the object.
+		const T& operator*() const;
+
+		// Access to the members of the object.
+		const T* operator->() const;
+
+		// Count of pointers sharing the object.
+		size_t use_count() const;
+
+		// A sign that the pointer owns an object.
+		explicit operator bool() const;
+
+	private:
+		// Let him make pointers to the objects he has created.
+		template<class U, class... Args> friend ImmutableSharedPtr<U> MakeImmutableShared(Args&&... args);
+
+		// The owned object in immutable memory.
+		T* Object;
+
+		// The counter of references to the object, found once when the object was created.
+		atomic<size_t>* References;
+
+		// A constructor that takes the object with its counter.
+		ImmutableSharedPtr(T* object, atomic<size_t>* references);
+
+	};
+
+	// Creates an immutable object owned by a shared pointer with a single allocation.
+	template<class T, class... Args> ImmutableSharedPtr<T> MakeImmutableShared(Args&&... args);
+
+	// A section of the current thread reading shared immutable objects, which retired objects are not destroyed under.
+	class ImmutableReader
+	{
+	public:
+		// Marks the thread as reading (sections may be nested).
+		ImmutableReader();
+
+		// Marks the thread as not reading when the outermost section ends.
+		~ImmutableReader();
+
+		// The section is bound to the scope, so it cannot be copied.
+		ImmutableReader(const ImmutableReader&) = delete;
+
+		// The section is bound to the scope, so it cannot be assigned.
+		ImmutableReader& operator=(const ImmutableReader&) = delete;
+	};
+
+	// Deferred destruction of shared immutable objects after every reader that could see them has left.
+	class ImmutableEpoch
+	{
+	public:
+		// Queues the objects for destruction after the grace period (reclamation is attempted once enough of them are waiting).
+		template<class T> static void Retire(T* p, size_t count_objects = 1);
+
+		// Destroys the retired objects no reader can see anymore, sealing each of their pages once. Returns count of the reclaimed retirements.
+		static size_t Collect();
+
+	private:
+		// Destroys the objects and frees their memory.
+		template<class T> static void Reclaim(void* p, size_t count_objects);
+	};
+
+	template<class T, class Hash> class ImmutableInternPool;
+
+	// A handle of a value interned in a pool, so that equal values share a single sealed instance.
+	template<class T> class Interned
+	{
+	public:
+		// A constructor of a handle that refers to nothing.
+		Interned();
+
+		// Access to the interned value.
+		const T* get() const;
+
+		// Access to the interned value.
+		const T& operator*() const;
+
+		// Access to the members of the interned value.
+		const T* operator->() const;
+
+		// The hash of the value computed once when it was interned.
+		size_t hash() const;
+
+		// A sign that both handles refer to the same value (equal values are interned once, so the addresses are compared).
+		bool operator==(const Interned& other) const;
+
+		// A sign that the handle refers to a value.
+		explicit operator bool() const;
+
+	private:
+		// Let him make handles of the values he has interned.
+		template<class U, class Hash> friend class ImmutableInternPool;
+
+		// A value with its hash, located together in immutable memory.
+		class Entry
+		{
+		public:
+			// Initialization of fields with the value moved into immutable memory.
+			Entry(size_t hashCode, T&& value);
+
+			// The hash of the value.
+			size_t HashCode;
+
+			// The interned value.
+			T Value;
+		};
+
+		// The entry in the pool (null if the handle refers to nothing).
+		const Entry* Target;
+
+		// A constructor of a handle that refers to the entry.
+		Interned(const Entry* target);
+	};
+
+	// A table of interned values, where every distinct value is kept once in immutable memory until the pool is destroyed.
+	template<class T, class Hash = hash<T>> class ImmutableInternPool
+	{
+	public:
+		// A constructor of an empty pool.
+		ImmutableInternPool();
+
+		// The pool owns the values, so it cannot be copied.
+		ImmutableInternPool(const ImmutableInternPool&) = delete;
+
+		// The pool owns the values, so it cannot be assigned.
+		ImmutableInternPool& operator=(const ImmutableInternPool&) = delete;
+
+		// Destroys every interned value, so the handles must not outlive the pool.
+		~ImmutableInternPool();
+
+		// Returns the interned instance equal to the key, making one from the key if there is none yet (lookups of different threads go concurrently).
+		template<class Key = T> Interned<T> Intern(const Key& key);
+
+		// Count of the interned values.
+		size_t size() const;
+
+	private:
+		// Count of the independently locked parts of the table.
+		static constexpr size_t ShardCount = 16;
+
+		// The entry the handles refer to.
+		using Entry = typename Interned<T>::Entry;
+
+		// A part of the table with its own lock.
+		class Shard
+		{
+		public:
+			// An object for synchronizing work with the part (lookups share it, insertions take it exclusively).
+			mutable shared_mutex Mutex;
+
+			// Entries of the part, grouped by the hash.
+			unordered_multimap<size_t, const Entry*> Entries;
+		};
+
+		// Parts of the table selected by the hash.
+		array<Shard, ShardCount> Shards;
+
+		// Looks for an entry equal to the key in the part. If success returns entry else returns null.
+		template<class Key> static const Entry* FindEntry(const Shard& shard, size_t hashCode, const Key& key);
+	};
+
+	// A pool of interned immutable strings, which can be looked up by any characters without freezing them first.
+	using ImmutableStringPool = ImmutableInternPool<FrozenString, hash<string_view>>;
+
+	// An immutable vector, every change of which makes a new version sharing all untouched nodes with the old one.
+	template<class T> class PersistentVector
+	{
+	public:
+		// For compatibility with algorithms from std.
+		using value_type = T;
+
+		// A constructor of an empty vector that takes no memory.
+		PersistentVector();
+
+		// A constructor that shares the nodes of another version without copying.
+		PersistentVector(const PersistentVector& other);
+
+		// A constructor that takes the nodes of another version.
+		PersistentVector(PersistentVector&& other) noexcept;
+
+		// Replaces the version with another one.
+		PersistentVector& operator=(PersistentVector other) noexcept;
+
+		// Releases the nodes no other version shares.
+		~PersistentVector();
+
+		// Count of the elements.
+		size_t size() const;
+
+		// A sign that there are no elements.
+		bool empty() const;
+
+		// Access to the element by its number.
+		const T& operator[](size_t index) const;
+
+		// Makes a version with the value added at the end.
+		PersistentVector push_back(const T& value) const;
+
+		// Makes a version without the last element.
+		PersistentVector pop_back() const;
+
+		// Makes a version with the element replaced by the value.
+		PersistentVector set(size_t index, const T& value) const;
+
+	private:
+		// Count of the bits of the element number consumed by a single level of the tree.
+		static constexpr size_t LevelBits = 5;
+
+		// Count of the children of a branch or the elements of a leaf.
+		static constexpr size_t Width = (size_t)1 << LevelBits;
+
+		// A node of the lowest level holding the elements.
+		class Leaf;
+
+		// A node of an upper level holding the nodes of the level below.
+		class Branch;
+
+		// The top node of the tree.
+		PersistentNode* Root;
+
+		// Count of the elements.
+		size_t Count;
+
+		// Count of the bits of the element number below the top level.
+		size_t Shift;
+
+		// A constructor that takes the reference to an already made tree.
+		PersistentVector(PersistentNode* root, size_t count, size_t shift);
+
+		// Makes a node in immutable memory.
+		template<class Node, class... Args> static Node* MakeNode(Args&&... args);
+
+		// Makes a leaf with the elements copied from the source except one replaced by the value.
+		static PersistentNode* MakeLeaf(const T* values, size_t count, size_t replacedIndex, const T* replacement);
+
+		// Makes a branch of the level sharing the children of the source except one replaced by a new node (which it takes the reference to).
+		static PersistentNode* MakeBranch(size_t level, PersistentNode* const* children, size_t count, size_t replacedIndex, PersistentNode* replacement);
+
+		// Makes a chain of nodes down to a leaf with the single value.
+		static PersistentNode* MakePath(size_t level, const T& value);
+
+		// Makes a copy of the path to the element replaced by the value.
+		static PersistentNode* SetNode(PersistentNode* node, size_t level, size_t index, const T& value);
+
+		// Makes a copy of the path to the end with the value added.
+		static PersistentNode* PushNode(PersistentNode* node, size_t level, size_t index, const T& value);
+
+		// Makes a copy of the path to the end without the last element. Returns null if nothing is left.
+		static PersistentNode* PopNode(PersistentNode* node, size_t level, size_t index);
+
+		// Removes a reference to the node, destroying it with its children if it was the last one.
+		static void ReleaseNode(PersistentNode* node, size_t level);
+	};
+
+	// An immutable hash map, every change of which makes a new version sharing all untouched nodes with the old one.
+	template<class K, class V, class Hash = hash<K>> class PersistentMap
+	{
+	public:
+		// For compatibility with algorithms from std.
+		using key_type = K;
+
+		// For compatibility with algorithms from std.
+		using mapped_type = V;
+
+		// A constructor of an empty map that takes no memory.
+		PersistentMap();
+
+		// A constructor that shares the nodes of another version without copying.
+		PersistentMap(const PersistentMap& other);
+
+		// A constructor that takes the nodes of another version.
+		PersistentMap(PersistentMap&& other) noexcept;
+
+		// Replaces the version with another one.
+		PersistentMap& operator=(PersistentMap other) noexcept;
+
+		// Releases the nodes no other version shares.
+		~PersistentMap();
+
+		// Count of the entries.
+		size_t size() const;
+
+		// A sign that there are no entries.
+		bool empty() const;
+
+		// Looks for the value of the key. If success returns value else returns null.
+		const V* find(const K& key) const;
+
+		// A sign that there is an entry with the key.
+		bool contains(const K& key) const;
+
+		// Makes a version with the key bound to the value.
+		PersistentMap set(const K& key, const V& value) const;
+
+		// Makes a version without the key.
+		PersistentMap erase(const K& key) const;
+
+	private:
+		// Count of the bits of the hash consumed by a single level of the tree.
+		static constexpr size_t LevelBits = 5;
+
+		// Count of the bits of the hash, after which keys with equal hashes are kept in a single node.
+		static constexpr size_t HashBits = sizeof(size_t) * 8;
+
+		// A key with its value.
+		class Entry;
+
+		// A node holding the entries and the nodes of the level below, both indexed by the bitmaps of the hash parts.
+		class Node;
+
+		// A pair of references to the key and the value to copy into a new entry.
+		using EntrySource = pair<const K*, const V*>;
+
+		// The top node of the tree.
+		Node* Root;
+
+		// Count of the entries.
+		size_t Count;
+
+		// A constructor that takes the reference to an already made tree.
+		PersistentMap(Node* root, size_t count);
+
+		// The part of the hash selecting the position in the node of the level.
+		static uint32_t GetBit(size_t hashCode, size_t shift);
+
+		// Makes a node sharing the children except a new one (which it takes the reference to).
+		static Node* MakeNode(uint32_t dataMap, uint32_t nodeMap, const vector<EntrySource>& entries, const vector<Node*>& children, Node* owned);
+
+		// Makes a node with two entries the hashes of which are equal down to the level.
+		static Node* MergeEntries(EntrySource first, size_t firstHash, EntrySource second, size_t secondHash, size_t shift);
+
+		// Makes a copy of the path to the key bound to the value.
+		static Node* InsertNode(Node* node, size_t shift, size_t hashCode, const K& key, const V& value, bool& isAdded);
+
+		// Makes a copy of the path to the key without it. Returns the node itself if there is no key and null if nothing is left.
+		static Node* RemoveNode(Node* node, size_t shift, size_t hashCode, const K& key, bool& isRemoved);
+
+		// Lists the sources of the entries of the node.
+		static vector<EntrySource> ListEntries(const Node* node);
+
+		// Lists the children of the node.
+		static vector<Node*> ListChildren(const Node* node);
+
+		// Removes a reference to the node, destroying it with its children if it was the last one.
+		static void ReleaseNode(Node* node);
+	};
+
+	// A memory resource for pmr containers, handing out writable memory while they are built and sealing all of it at once.
+	class ImmutableMemoryResource : public pmr::memory_resource
+	{
+	public:
+		// A constructor that takes no memory until the first allocation (the first run is at least the initial size).
+		ImmutableMemoryResource(size_t initialSize = 0);
+
+		// Returns all the memory to the system (objects in it must be destroyed before, without writing to it).
+		~ImmutableMemoryResource();
+
+		// The resource owns its memory, so it cannot be copied.
+		ImmutableMemoryResource(const ImmutableMemoryResource&) = delete;
+
+		// The resource owns its memory, so it cannot be assigned.
+		ImmutableMemoryResource& operator=(const ImmutableMemoryResource&) = delete;
+
+		// Closes all the memory for writing, after which the resource allocates nothing.
+		void Seal();
+
+		// A sign that the memory is closed for writing.
+		bool IsSealed() const;
+
+	protected:
+		// Takes the memory from the current run, or from a new one twice as large if the current one is used up.
+		void* do_allocate(size_t bytes, size_t alignment) override;
+
+		// Memory is only returned when the resource is destroyed, so nothing happens.
+		void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+
+		// Memory of one resource cannot be freed by another.
+		bool do_is_equal(const pmr::memory_resource& other) const noexcept override;
+
+	private:
+		// Runs of memory taken from the region, each one a single page.
+		vector<MemoryPage*> Pages;
+
+		// The first free byte of the current run.
+		char* Cursor;
+
+		// The end of the current run.
+		char* End;
+
+		// Size of the next run to take.
+		size_t NextRunSize;
+
+		// A sign that the memory is closed for writing.
+		bool Sealed;
+	};
+
+	// Storage owning its pages outright, in which objects are sealed one by one and all released at once (used by one thread at a time).
+	class ImmutableRegion
+	{
+	public:
+		// A constructor that takes no memory until the first object (the first run is at least the initial size).
+		ImmutableRegion(size_t initialSize = 0);
+
+		// Releases all the objects of the region.
+		~ImmutableRegion();
+
+		// The region owns its objects, so it cannot be copied.
+		ImmutableRegion(const ImmutableRegion&) = delete;
+
+		// The region owns its objects, so it cannot be assigned.
+		ImmutableRegion& operator=(const ImmutableRegion&) = delete;
+
+		// Creates an object in the region, sealed right after it is constructed (or when the batch of the thread is committed, so that building many objects opens the pages only once).
+		template<class T, class... Args> T* Create(Args&&... args);
+
+		// Creates a sequence of objects with the same arguments in the region, opening their memory for writing only once.
+		template<class T, class... Args> T* CreateArray(size_t count, Args&&... args);
+
+		// Destroys the objects that need it in the reverse order of creating and returns all the pages to the system.
+		void Release();
+
+		// Size of the memory taken by the objects of the region.
+		size_t size() const;
+
+	private:
+		// Let him have access to sealing the pages kept open in the batch.
+		friend class ImmutableBatch;
+
+		// A record of objects whose destructor must be called when the region is released.
+		class Finalizer
+		{
+		public:
+			// Address of the first object.
+			void* Address;
+
+			// Count of objects in a row.
+			size_t Count;
+
+			// Calls the destructor for every object.
+			void (*Destroy)(void* address, size_t count);
+		};
+
+		// Runs of memory taken from the region, each one a single page.
+		vector<MemoryPage*> Pages;
+
+		// Objects with destructors in the order of creating.
+		vector<Finalizer> Finalizers;
+
+		// Pages around the objects being constructed, sealed when the outermost construction ends.
+		vector<pair<void*, size_t>> OpenSpans;
+
+		// Depth of nested constructions (an object may create others in the region while being constructed).
+		size_t OpenDepth;
+
+		// The batch keeping the pages open for writing until it is committed (null if there is none).
+		ImmutableBatch* OpenBatch;
+
+		// Index of the first page kept open by the batch (every later page is open too).
+		size_t FirstOpenPage;
+
+		// The first free byte of the current run.
+		char* Cursor;
+
+		// The end of the current run.
+		char* End;
+
+		// Size of the next run to take.
+		size_t NextRunSize;
+
+		// Size of the memory taken by the objects.
+		size_t UsedSize;
+
+		// Takes memory from the current run, extends the run or takes a new one twice as large if it is used up.
+		void* TakeMemory(size_t size, size_t alignment);
+
+		// Opens for writing the pages around the memory of the objects.
+		void OpenSpan(void* address, size_t size);
+
+		// Seals the opened pages if the outermost construction has ended.
+		void CloseSpans();
+
+		// Opens the current page until the batch of the thread is committed if there is a batch. Returns true if the pages are kept open.
+		bool KeepOpenInBatch();
+
+		// Seals the pages kept open by the batch.
+		void SealBatchPages();
+
+		// Adds the calls of the protector to the counters of the thread heap.
+		static void CountCalls(HeapCounter HeapStatistics::* counter, size_t count = 1);
+
+		// Calls the destructors for a sequence of objects of the type.
+		template<class T> static void DestroyObjects(void* address, size_t count);
+	};
+
+	// Compression of sealed pages not touched for a while, which returns their memory to the system and restores them on the next access (not with the writable alias).
+	class ImmutableColdPages
+	{
+	public:
+		// Compresses the sealed pages of all heaps not sealed or restored for the age. Returns count of compressed pages.
+		static size_t Compress(chrono::steady_clock::duration age);
+
+	private:
+		// Let him have access to restoring pages before opening them for writing.
+		template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> friend class BasicImmutableAllocator;
+
+		// Count of restored pages, telling a fault that raced with a restoring from a real one.
+		static inline atomic<size_t> RestoredCount = 0;
+
+		// Installs the handler of faults on the first compression.
+		static void HandleFaultsOnce();
+
+		// Restores the page of the faulting address if it is compressed. Returns true if the access can be retried.
+		static bool HandleFault(void* address);
+
+		// Compresses the contents of the page and hides its memory. Returns false if the contents do not compress well enough.
+		static bool CompressPage(MemoryPage* page);
+
+		// Restores the contents of the page if they are compressed (waits if another thread is already doing it).
+		static void Restore(MemoryPage* page);
+	};
+
+	// Recording of the allocator calls of all threads into a binary file, for replaying real workloads against other allocator configurations offline.
+	class ImmutableTrace
+	{
+	public:
+		// Starts recording the calls into the file (only one recording at a time).
+		static void Start(const string& path);
 
-		// Searches for a memory blocks sequence by first block starting address. If success returns first block else throws an exception.
-		static MemoryBlock* FindMemoryBlocksAndReturnFirst(void* startAddress, size_t blockSize, size_t blockCount);
+		// Stops recording and writes the calls left in the buffers of the threads.
+		static void Stop();
 
-		// Inserts a page into the list of managed pages in order of increasing free memory.
-		static void InsertMemoryPageInCache(MemoryPage* page);
+		// Reads the calls recorded in the file ordered by their time.
+		static vector<TraceRecord> Load(const string& path);
 	};
 };
 
-#include "..\source\immutable_allocator.h"
-#include "..\source\immutable_guard.h"
\ No newline at end of file
+#include "../source/immutable_page_source.h"
+#include "../source/immutable_allocator.h"
+#include "../source/immutable_batch.h"
+#include "../source/immutable_guard.h"
+#include "../source/frozen_vector.h"
+#include "../source/frozen_string.h"
+#include "../source/snapshot_pointer.h"
+#include "../source/immutable_snapshot.h"
+#include "../source/immutable_snapshot_builder.h"
+#include "../source/immutable_statistics.h"
+#include "../source/immutable_pool.h"
+#include "../source/immutable_shared_ptr.h"
+#include "../source/immutable_reader.h"
+#include "../source/immutable_epoch.h"
+#include "../source/interned.h"
+#include "../source/immutable_intern_pool.h"
+#include "../source/persistent_vector.h"
+#include "../source/persistent_map.h"
+#include "../source/immutable_memory_resource.h"
+#include "../source/immutable_region.h"
+#include "../source/immutable_cold_pages.h"
+#include "../source/immutable_trace.h"
\ No newline at end of file
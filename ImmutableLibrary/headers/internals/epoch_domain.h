@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "memory_heap.h"
+
+using namespace std;
+
+namespace immutable::internals
+{
+	// Objects waiting for every reader that could see them to leave.
+	class RetiredObject
+	{
+	public:
+		// Initialization of fields.
+		RetiredObject(void* address, size_t count, void (*reclaim)(void*, size_t), size_t epoch);
+
+		// Address of the first object in memory.
+		void* Address;
+
+		// Count of objects in a row.
+		size_t Count;
+
+		// The function that destroys the objects and frees their memory.
+		void (*Reclaim)(void*, size_t);
+
+		// The epoch the objects were retired in.
+		size_t Epoch;
+	};
+
+	// A domain of deferred reclamation, where objects are destroyed only after the readers of the epoch they were retired in have left.
+	class EpochDomain
+	{
+	public:
+		// Initialization of fields.
+		EpochDomain();
+
+		// Count of waiting objects after which retiring more of them should attempt reclamation.
+		static constexpr size_t CollectThreshold = 64;
+
+		// Marks the thread of the heap as reading in the current epoch (nested calls only count the depth).
+		void Enter(MemoryHeap* heap);
+
+		// Marks the thread of the heap as not reading when the outermost call is left.
+		void Leave(MemoryHeap* heap);
+
+		// Queues the objects in the current epoch. Returns true if enough objects are waiting to attempt reclamation.
+		bool Retire(void* address, size_t count, void (*reclaim)(void*, size_t));
+
+		// Advances the epoch if every reader has seen the current one and takes the objects no reader can see anymore.
+		vector<RetiredObject> TakeReclaimable();
+
+	private:
+		// The current epoch (starting with one, since zero marks a thread that is not reading).
+		atomic<size_t> GlobalEpoch;
+
+		// An object for synchronizing work with the waiting objects.
+		mutex Mutex;
+
+		// Objects waiting for the end of the grace period.
+		vector<RetiredObject> RetiredObjects;
+
+		// Moves the epoch forward if no thread is reading in an older one. Returns the current epoch.
+		size_t TryAdvance();
+	};
+};
\ No newline at end of file
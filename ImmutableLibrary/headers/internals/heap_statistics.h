@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+
+using namespace std;
+
+namespace immutable::internals
+{
+	// A counter that is changed by a single writer at a time (the holder of the exclusive heap lock, or the owner thread alone) and read by anyone without locking.
+	class HeapCounter
+	{
+	public:
+		// Initialization of fields.
+		HeapCounter();
+
+		// Increases the counter (writers are serialized by the heap lock, so a plain store is enough).
+		void Add(size_t value);
+
+		// Decreases the counter (writers are serialized by the heap lock, so a plain store is enough).
+		void Subtract(size_t value);
+
+		// The current value of the counter.
+		size_t Read() const;
+
+	private:
+		// The value of the counter.
+		atomic<size_t> Value;
+	};
+
+	// Counters of a single heap, which are summed up over all heaps only when the statistics are read.
+	class HeapStatistics
+	{
+	public:
+		// Count of buckets in the histogram of allocation sizes.
+		static constexpr size_t HistogramSize = 64;
+
+		// Count of pages taken from the system and not yet returned.
+		HeapCounter LivePages;
+
+		// Count of allocated blocks.
+		HeapCounter LiveBlocks;
+
+		// Size of allocated blocks.
+		HeapCounter LiveBytes;
+
+		// Count of empty pages kept for new allocations.
+		HeapCounter RetainedPages;
+
+		// Size of the page tails that are too short for another slot.
+		HeapCounter WastedTailBytes;
+
+		// Count of calls closing pages for writing.
+		HeapCounter ProtectCalls;
+
+		// Count of calls opening pages for writing.
+		HeapCounter UnprotectCalls;
+
+		// Count of calls taking pages from the system.
+		HeapCounter MapCalls;
+
+		// Count of calls returning pages to the system.
+		HeapCounter UnmapCalls;
+
+		// Count of calls closing pages for writing made by the regions of the owner thread, which alone changes it without locking.
+		HeapCounter RegionProtectCalls;
+
+		// Count of calls opening pages for writing made by the regions of the owner thread, which alone changes it without locking.
+		HeapCounter RegionUnprotectCalls;
+
+		// Count of calls taking pages from the system made by the regions of the owner thread, which alone changes it without locking.
+		HeapCounter RegionMapCalls;
+
+		// Count of calls returning pages to the system made by the regions of the owner thread, which alone changes it without locking.
+		HeapCounter RegionUnmapCalls;
+
+		// Count of exclusive heap lock acquisitions.
+		HeapCounter LockAcquisitions;
+
+		// Count of exclusive heap lock acquisitions that had to wait for another thread.
+		HeapCounter ContendedLockAcquisitions;
+
+		// Time spent waiting for the exclusive heap lock.
+		HeapCounter LockWaitNanoseconds;
+
+		// Time the exclusive heap lock was held (only counted while lock timing is enabled).
+		HeapCounter LockHoldNanoseconds;
+
+		// Count of allocations by size, where the bucket N holds sizes from 2^(N-1) to 2^N - 1 bytes.
+		HeapCounter AllocationSizes[HistogramSize];
+
+		// Counts the allocation in the bucket of its size.
+		void CountAllocation(size_t allocationSize);
+
+		// A sign that the time of holding heap locks is counted (it costs two clock readings per lock).
+		static inline atomic<bool> IsLockTimingEnabled = false;
+	};
+};
\ No newline at end of file
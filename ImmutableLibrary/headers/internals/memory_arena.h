@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "memory_page.h"
+
+using namespace std;
+
+namespace immutable::internals
+{
+	// Information about a contiguous virtual address region reserved for all memory pages.
+	class MemoryArena
+	{
+	public:
+		// Initialization of fields with an already reserved region.
+		MemoryArena(void* startAddress, size_t totalSize, size_t pageSize);
+
+		// The base address of the reserved region.
+		char* StartAddress;
+
+		// The size of the reserved region.
+		size_t TotalSize;
+
+		// Binary logarithm of the size of the pages the region is divided into.
+		size_t PageShift;
+
+		// Takes an unused run of addresses from the region. If success returns run address else returns null.
+		void* CatchRun(size_t runSize);
+
+		// Takes the unused run of addresses starting exactly at the address. Returns true if the whole run was unused.
+		bool CatchRunAt(void* startAddress, size_t runSize);
+
+		// Returns a run of addresses to the region for reuse.
+		void FreeRun(void* startAddress, size_t runSize);
+
+		// Associates every page of the region covered by the memory page with it in the table.
+		void BindPage(MemoryPage* page);
+
+		// Removes the association of every page of the region covered by the memory page in the table.
+		void UnbindPage(MemoryPage* page);
+
+		// Searches for the memory page containing the address without locking. If success returns page else returns null.
+		MemoryPage* FindPage(void* address);
+
+	private:
+		// An object for synchronizing work with unused runs of addresses.
+		mutex Mutex;
+
+		// Region padding offset.
+		size_t FillOffset;
+
+		// Previously used runs of addresses, ordered by the starting address.
+		vector<pair<char*, size_t>> FreeRuns;
+
+		// Memory page for every page of the region.
+		atomic<MemoryPage*>* PagesTable;
+
+		// Sets the table entries for every page of the region covered by the memory page.
+		void StorePage(MemoryPage* page, MemoryPage* value);
+	};
+};
\ No newline at end of file
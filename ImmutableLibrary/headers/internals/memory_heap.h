@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "memory_page.h"
+#include "heap_statistics.h"
+
+using namespace std;
+
+namespace immutable::internals
+{
+	// Information about memory blocks released by a thread that does not own them.
+	class RemoteRelease
+	{
+	public:
+		// Initialization of fields.
+		RemoteRelease(void* startAddress, size_t blockSize, size_t blockCount);
+
+		// Address of the first released block in memory.
+		void* StartAddress;
+
+		// The size of a single released block.
+		size_t BlockSize;
+
+		// Count of released blocks in a row.
+		size_t BlockCount;
+
+		// The next record in the queue of remote releases.
+		RemoteRelease* Next;
+	};
+
+	class MemoryHeapPool;
+
+	// Information about memory pages owned by a single thread.
+	class MemoryHeap
+	{
+	public:
+		// Initialization of fields.
+		MemoryHeap();
+
+		// An object for synchronizing work with the heap (only contended when threads touch each other's objects).
+		shared_mutex Mutex;
+
+		// Heap-managed memory pages with free slots, grouped by the slot size.
+		unordered_map<size_t, list<MemoryPage*>> MemoryPages;
+
+		// Empty pages kept taken from the system for new allocations, grouped by the page size.
+		unordered_map<size_t, vector<MemoryPage*>> RetainedPages;
+
+		// Pages holding blocks of the heap, kept for visiting every one of them (such as for checking or compressing).
+		unordered_set<MemoryPage*> UsedPages;
+
+		// Total size of the retained pages.
+		size_t RetainedSize;
+
+		// Lock-free queue of blocks released by other threads and waiting to be freed by the owner.
+		atomic<RemoteRelease*> RemoteReleases;
+
+		// Counters of the heap, changed under its exclusive lock.
+		HeapStatistics Statistics;
+
+		// The epoch the owner thread entered reading in (zero if it is not reading).
+		atomic<size_t> ReaderEpoch;
+
+		// Depth of nested reading sections of the owner thread.
+		size_t ReaderDepth;
+
+		// The pool the heap returns to when its thread ends.
+		MemoryHeapPool* OwnerPool;
+
+		// Puts a record into the queue of remote releases without locking.
+		void PushRemoteRelease(RemoteRelease* release);
+
+		// Takes all records from the queue of remote releases at once without locking.
+		RemoteRelease* TakeRemoteReleases();
+
+		// Gives a heap of the pool to the calling thread (a heap of the pool abandoned by a finished thread is reused first).
+		static MemoryHeap* Acquire(MemoryHeapPool& pool);
+
+		// Keeps the heap of a finished thread alive in its pool, since its objects may still be used by other threads.
+		static void Abandon(MemoryHeap* heap);
+
+		// Lists every heap ever created (heaps are never destroyed, so the list only grows).
+		static vector<MemoryHeap*> GetAllHeaps();
+
+	private:
+		// An object for synchronizing work with abandoned heaps of all pools and the list of all heaps.
+		static inline mutex AbandonedMutex;
+
+		// Every heap ever created.
+		static inline list<MemoryHeap*> AllHeaps;
+	};
+
+	// Heaps of a single page source, which are reused only by the threads of the same source since they hold its pages.
+	class MemoryHeapPool
+	{
+	public:
+		// Heaps of finished threads waiting for a new owner.
+		list<MemoryHeap*> AbandonedHeaps;
+	};
+
+	// Exclusive ownership of the heap lock for the scope, counting the time of waiting and holding it.
+	class MemoryHeapLock
+	{
+	public:
+		// Locks the heap exclusively.
+		MemoryHeapLock(MemoryHeap* heap);
+
+		// Unlocks the heap.
+		~MemoryHeapLock();
+
+		// The lock is bound to the scope, so it cannot be copied.
+		MemoryHeapLock(const MemoryHeapLock&) = delete;
+
+		// The lock is bound to the scope, so it cannot be assigned.
+		MemoryHeapLock& operator=(const MemoryHeapLock&) = delete;
+
+	private:
+		// The locked heap.
+		MemoryHeap* Heap;
+
+		// A sign that the time of holding the lock is counted.
+		bool IsTimed;
+
+		// The moment the lock was acquired (only if the time of holding is counted).
+		chrono::steady_clock::time_point AcquiredTime;
+	};
+
+	// Binding of a heap to the thread for the lifetime of the thread.
+	class MemoryHeapLease
+	{
+	public:
+		// Acquires a heap of the pool for the thread.
+		MemoryHeapLease(MemoryHeapPool& pool);
+
+		// Abandons the heap when the thread ends.
+		~MemoryHeapLease();
+
+		// The heap owned by the thread.
+		MemoryHeap* Heap;
+	};
+};
\ No newline at end of file
@@ -1,11 +1,48 @@
 #pragma once
 
-#include <map>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
 
 using namespace std;
 
 namespace immutable::internals
 {
+	class MemoryHeap;
+
+	// States of a sealed page on its way to being compressed and back.
+	enum class PageTemperature
+	{
+		// The page holds its contents.
+		Warm,
+
+		// The page is being compressed, so it may fault any moment.
+		Cooling,
+
+		// The contents are compressed and the memory is returned to the system, so any access faults.
+		Cold,
+
+		// The contents are being restored by one of the threads that faulted.
+		Warming
+	};
+
+	// Counters of references to the shared objects of neighbouring slots, made at once for the whole group.
+	class ReferenceCountGroup
+	{
+	public:
+		// Count of slots in the group.
+		static constexpr size_t Size = 64;
+
+		// The counters of the slots.
+		atomic<size_t> Counts[Size];
+
+		// Count of counters of the group in use.
+		size_t UsedCount = 0;
+	};
+
 	// Information about allocated memory page.
 	class MemoryPage
 	{
@@ -19,10 +56,88 @@ namespace immutable::internals
 		// Page size for the case of allocating several system pages in a row for large objects.
 		size_t TotalSize;
 
-		// Page padding offset.
-		size_t FillOffset;
+		// The size of every slot of the page (a page only holds blocks of the same size).
+		size_t SlotSize;
+
+		// Count of slots that fit on the page.
+		size_t SlotsCount;
 
 		// Count of associated memory blocks.
 		size_t BlocksCount;
+
+		// Count of writers that keep the page open for writing at the moment.
+		size_t UnlockCount;
+
+		// The heap of the thread that owns the page.
+		MemoryHeap* OwnerHeap;
+
+		// A sign that the page is in the heap list of pages with free slots.
+		bool IsCached;
+
+		// Checksum of the contents of the sealed page (only kept by protectors that do not seal pages with the hardware).
+		uint32_t Checksum;
+
+		// Position of the page in the heap list of pages with free slots.
+		list<MemoryPage*>::iterator CachePosition;
+
+		// A bitmap of slots with bits set for free slots.
+		vector<uint64_t> FreeSlotsBitmap;
+
+		// A bitmap of slots with bits set for slots initialized with value.
+		vector<uint64_t> InitializedSlotsBitmap;
+
+		// Counters of references to the shared objects of the page by groups of slots, kept aside from the sealed page (empty if no object of the page is shared).
+		vector<unique_ptr<ReferenceCountGroup>> ReferenceCounts;
+
+		// Whether the page holds its contents or they are compressed.
+		atomic<PageTemperature> Temperature;
+
+		// The moment the page was last sealed or restored, in ticks of the steady clock.
+		atomic<chrono::steady_clock::rep> LastTouchTime;
+
+		// Compressed contents of the page, kept until the page is opened for writing (null if it was never compressed since).
+		unique_ptr<uint8_t[]> CompressedContents;
+
+		// Size of the compressed contents.
+		size_t CompressedSize;
+
+		// Remembers the current moment as the last touch of the page.
+		void Touch();
+
+		// Makes the counter of references to the object of the slot set to a single reference.
+		atomic<size_t>* CreateReferenceCount(size_t slot);
+
+		// Drops the counter of references to the object of the slot, and its group with the last counter of the group.
+		void ReleaseReferenceCount(size_t slot);
+
+		// Splits the page into slots of the same size, all of them free.
+		void FormatSlots(size_t slotSize);
+
+		// Adds free slots for the memory the page has grown by.
+		void ExtendSlots();
+
+		// Looks for a sequence of free slots starting at a multiple of the step. If success returns first slot number else returns slots count.
+		size_t FindFreeSlots(size_t slotCount, size_t slotStep = 1);
+
+		// Marks a sequence of slots as occupied.
+		void CatchSlots(size_t firstSlot, size_t slotCount);
+
+		// Marks a sequence of slots as free.
+		void ReleaseSlots(size_t firstSlot, size_t slotCount);
+
+		// Checks that every slot of the sequence is free.
+		bool AreSlotsFree(size_t firstSlot, size_t slotCount);
+
+		// Checks that every slot of the sequence is occupied by a block.
+		bool AreSlotsCatched(size_t firstSlot, size_t slotCount);
+
+		// Checks that the slot is initialized with value.
+		bool IsSlotInitialized(size_t slot);
+
+		// Checks that at least one slot of the sequence is initialized with value.
+		bool IsAnySlotInitialized(size_t firstSlot, size_t slotCount);
+
+		// Marks the slot as initialized with value or not.
+		void SetSlotInitialized(size_t slot, bool isInitialized);
 	};
-};
+};
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+namespace immutable::internals
+{
+	// CRC32C of memory contents, computed by the processor instruction where there is one.
+	class PageChecksum
+	{
+	public:
+		// Computes the checksum of the memory run.
+		static uint32_t Compute(const void* startAddress, size_t size);
+
+	private:
+		// Computes the checksum eight bytes at a time with the processor instruction.
+		static uint32_t ComputeWithInstruction(const uint8_t* bytes, size_t size);
+
+		// Computes the checksum eight bytes at a time with lookup tables.
+		static uint32_t ComputeWithTables(const uint8_t* bytes, size_t size);
+
+		// A sign that the processor has the instruction, checked once.
+		static bool HasInstruction();
+	};
+};
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+namespace immutable::internals
+{
+	// A fast byte-oriented compression of memory contents, in the manner of LZ4: runs of literals followed by copies of earlier bytes.
+	class PageCodec
+	{
+	public:
+		// The largest size of the compressed contents of the size.
+		static size_t GetCompressedBound(size_t size);
+
+		// Compresses the memory run into the target of the bound size. Returns the compressed size.
+		static size_t Compress(const void* startAddress, size_t size, uint8_t* target);
+
+		// Restores the compressed contents into the memory run (allocates nothing, so it is safe in a signal handler).
+		static void Decompress(const uint8_t* compressed, size_t compressedSize, void* startAddress);
+
+	private:
+		// Count of bits of the hash of four bytes looked up for earlier occurrences.
+		static constexpr size_t HashBits = 12;
+
+		// The farthest back a copy can reach.
+		static constexpr size_t MaxOffset = 65535;
+
+		// The shortest copy worth encoding.
+		static constexpr size_t MinMatch = 4;
+
+		// Writes a length that did not fit into its part of the token as a run of bytes.
+		static uint8_t* WriteLength(uint8_t* target, size_t length);
+
+		// Reads a length that did not fit into its part of the token.
+		static size_t ReadLength(const uint8_t*& compressed);
+	};
+};
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+
+using namespace std;
+
+namespace immutable::internals
+{
+	// A node of a persistent container shared by every version that contains it.
+	class PersistentNode
+	{
+	public:
+		// Initialization of fields with the counter made for the node aside from its sealed page, holding the single reference of the creator.
+		PersistentNode(atomic<size_t>* references);
+
+		// The node is shared by reference, so it cannot be copied.
+		PersistentNode(const PersistentNode&) = delete;
+
+		// The node is shared by reference, so it cannot be assigned.
+		PersistentNode& operator=(const PersistentNode&) = delete;
+
+		// Adds a reference to the node.
+		void Acquire();
+
+		// Removes a reference to the node. Returns true if it was the last one.
+		bool Release();
+
+	private:
+		// Count of references kept in mutable memory by the page of the node, since the node itself stays sealed.
+		atomic<size_t>* References;
+	};
+};
\ No newline at end of file
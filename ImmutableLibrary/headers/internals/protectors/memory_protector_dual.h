@@ -0,0 +1,67 @@
+#pragma once
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <pthread.h>
+#include <fstream>
+#include <sstream>
+
+#include "memory_protector_unix.h"
+
+using namespace std;
+
+namespace immutable::internals::protectors
+{
+	// Maps the same memory twice: a read-only view handed to users and a writable alias used only by the allocator.
+	class MemoryProtectorDual : public MemoryProtectorUnix
+	{
+	public:
+		// A sign that plain objects can be written through the alias without unlocking their pages.
+		static constexpr bool HasWritableAlias = true;
+
+		// Getting the huge memory page size (the memory file has usual pages, so it is the usual page size).
+		static size_t GetHugeMemoryPageSize();
+
+		// Creates the memory file of the region size and maps it twice without any memory behind it yet.
+		static void* ReserveRegion(size_t regionSize, size_t pageSize);
+
+		// Releases a page of memory into the system, keeping its addresses reserved.
+		static void FreePage(MemoryPage* page);
+
+		// Retrieves non-writable memory for the whole run of addresses at once, faulting it in right away.
+		static void PopulateRegion(void* startAddress, size_t regionSize);
+
+		// Lets the system take the memory of the page (the memory file cannot be freed lazily, so right away).
+		static void DiscardPage(MemoryPage* page);
+
+		// Moves the memory of the page to a larger run of reserved addresses by copying it through the alias (the view cannot be moved apart from the memory file).
+		static void MovePage(MemoryPage* page, void* startAddress, size_t pageSize);
+
+		// Address of the same memory in the writable alias.
+		static void* GetWritableAddress(void* address);
+
+	private:
+		// The memory file behind both mappings.
+		static inline int MemoryFile = -1;
+
+		// The read-only view of the memory file.
+		static inline char* ViewAddress = nullptr;
+
+		// The writable alias of the memory file at an address unrelated to the view.
+		static inline char* AliasAddress = nullptr;
+
+		// Size of both mappings of the memory file.
+		static inline size_t RegionSize = 0;
+
+		// Gives a forked child its own copy of the memory file, so that its allocations never reach the parent.
+		static void SeparateChild();
+
+		// Returns the memory of the page to the system by punching a hole in the memory file.
+		static void PunchPage(void* startAddress, size_t pageSize);
+	};
+};
+#endif
\ No newline at end of file
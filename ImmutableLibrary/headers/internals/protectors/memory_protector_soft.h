@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "../memory_page.h"
+#include "../page_checksum.h"
+
+#ifdef _WIN32
+#include "memory_protector_windows.h"
+#else
+#include "memory_protector_unix.h"
+#endif
+
+using namespace std;
+
+namespace immutable::internals::protectors
+{
+#ifdef _WIN32
+	// The protector of the platform, which only maps the pages for the soft one.
+	using MemoryProtectorHard = MemoryProtectorWindows;
+#else
+	// The protector of the platform, which only maps the pages for the soft one.
+	using MemoryProtectorHard = MemoryProtectorUnix;
+#endif
+
+	// Seals pages with checksums instead of the hardware: pages stay writable, and a write to a sealed page is found when the page is checked.
+	class MemoryProtectorSoft : public MemoryProtectorHard
+	{
+	public:
+		// A sign that sealed pages keep checksums that can be checked.
+		static constexpr bool HasChecksums = true;
+
+		// Retrieves a memory page from the system that stays writable for all its life.
+		static MemoryPage* CatchPage(void* startAddress, size_t pageSize);
+
+		// Retrieves writable memory for the reserved addresses right after the page, making the page larger in place.
+		static void ExtendPage(MemoryPage* page, size_t pageSize);
+
+		// Moves the memory of the page to a larger run of reserved addresses, checking it before and sealing it again after.
+		static void MovePage(MemoryPage* page, void* startAddress, size_t pageSize);
+
+		// Seals the page by computing the checksum of its contents.
+		static void LockPage(MemoryPage* page);
+
+		// Checks the sealed page against its checksum before it is written again. If it was changed throws an exception.
+		static void UnlockPage(MemoryPage* page);
+
+		// Checks that the contents of the sealed page still match its checksum.
+		static bool VerifyPage(MemoryPage* page);
+	};
+};
\ No newline at end of file
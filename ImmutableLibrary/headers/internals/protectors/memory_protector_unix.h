@@ -2,13 +2,21 @@
 
 #ifdef __unix__
 #include <sys/mman.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
 #include <string.h>
 
+#include <cstdint>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <string>
 
-#include "..\memory_page.h"
+#include "../memory_page.h"
 
 using namespace std;
 
@@ -18,20 +26,100 @@ namespace immutable::internals::protectors
 	class MemoryProtectorUnix
 	{
 	public:
+		// A sign that plain objects can be written through an alias without unlocking their pages (there is no alias here).
+		static constexpr bool HasWritableAlias = false;
+
+		// A sign that sealed pages keep checksums that can be checked (the hardware seals them here).
+		static constexpr bool HasChecksums = false;
+
 		// Getting the memory page size depending on the platform.
 		static size_t GetMemoryPageSize();
 
-		// Retrieves a non-writable memory page from the system.
-		static MemoryPage* CatchPage(size_t pageSize);
+		// Getting the huge memory page size depending on the platform (the usual page size if there are no huge pages).
+		static size_t GetHugeMemoryPageSize();
+
+		// Reserves a region of addresses aligned to the page size without any memory behind it.
+		static void* ReserveRegion(size_t regionSize, size_t pageSize);
+
+		// Retrieves a non-writable memory page from the system at the address inside a reserved region.
+		static MemoryPage* CatchPage(void* startAddress, size_t pageSize);
 
-		// Releases a page of memory into the system.
+		// Releases a page of memory into the system, keeping its addresses reserved.
 		static void FreePage(MemoryPage* page);
 
+		// Retrieves non-writable memory for the whole run of addresses at once, faulting it in right away.
+		static void PopulateRegion(void* startAddress, size_t regionSize);
+
+		// Lets the system take the memory of the page when it runs short, while the page stays usable.
+		static void DiscardPage(MemoryPage* page);
+
+		// Retrieves non-writable memory for the reserved addresses right after the page, making the page larger in place.
+		static void ExtendPage(MemoryPage* page, size_t pageSize);
+
+		// Moves the memory of the page to a larger run of reserved addresses (without copying where the system can), leaving the old addresses reserved.
+		static void MovePage(MemoryPage* page, void* startAddress, size_t pageSize);
+
 		// Closes the memory page for recording.
 		static void LockPage(MemoryPage* page);
 
 		// Opens the memory page for recording.
 		static void UnlockPage(MemoryPage* page);
+
+		// Maps the whole file into memory for reading only, sharing its pages with other processes.
+		static void* MapFile(const string& path, size_t& fileSize);
+
+		// Removes the mapping of the file from memory.
+		static void UnmapFile(void* startAddress, size_t fileSize);
+
+#ifdef __linux__
+		// Creates a memory file with the contents and seals it, so no process can ever change it.
+		static int CreateSealedMemory(const void* contents, size_t contentsSize);
+
+		// Maps the whole sealed memory file into memory for reading only, sharing its pages with other processes.
+		static void* MapSealedMemory(int sealedMemory, size_t& memorySize);
+
+		// Returns the memory of the sealed page to the system and forbids any access to it, so that the next one faults.
+		static void HidePage(MemoryPage* page);
+
+		// Maps writable memory aside to prepare the contents of a hidden page in.
+		static void* MapScratch(size_t size);
+
+		// Seals the prepared memory and puts it in place of the hidden page at once, so that no one sees the contents half-done.
+		static void ReplacePage(MemoryPage* page, void* scratch);
+
+		// Installs the handler of memory access faults, which tells by the address whether it dealt with the fault (other faults go to the handler installed before).
+		static void HandleFaults(bool (*handler)(void* address));
+#endif
+
+		// Passes a copy of the descriptor to the process on the other side of the local socket.
+		static void SendDescriptor(int socket, int descriptor);
+
+		// Takes a descriptor passed by the process on the other side of the local socket.
+		static int ReceiveDescriptor(int socket);
+
+		// Address of the same memory in the writable alias (there is no alias here, so it is never called).
+		static void* GetWritableAddress(void* address);
+
+	private:
+		// Maps the whole opened file into memory for reading only.
+		static void* MapDescriptor(int descriptor, size_t& fileSize);
+
+#ifdef __linux__
+		// Calls the installed handler of faults and passes the faults it did not deal with to the handler installed before.
+		static void HandleFault(int signalNumber, siginfo_t* signalInfo, void* context);
+
+		// The handler of faults installed by the allocator.
+		static inline bool (*FaultHandler)(void* address) = nullptr;
+
+		// The handler of faults installed before the allocator's one.
+		static inline struct sigaction PreviousFaultAction = {};
+#endif
+
+		// A sign that the region is backed by the pool of explicit huge pages.
+		static inline bool IsHugeTlbRegion = false;
+
+		// A sign that the region is advised to be backed by transparent huge pages.
+		static inline bool IsTransparentHugeRegion = false;
 	};
 };
 #endif
\ No newline at end of file
@@ -6,9 +6,11 @@
 #include <sysinfoapi.h>
 #include <errhandlingapi.h>
 
+#include <cstring>
 #include <iostream>
+#include <string>
 
-#include "..\memory_page.h"
+#include "../memory_page.h"
 
 using namespace std;
 
@@ -18,20 +20,53 @@ namespace immutable::internals::protectors
 	class MemoryProtectorWindows
 	{
 	public:
+		// A sign that plain objects can be written through an alias without unlocking their pages (there is no alias here).
+		static constexpr bool HasWritableAlias = false;
+
+		// A sign that sealed pages keep checksums that can be checked (the hardware seals them here).
+		static constexpr bool HasChecksums = false;
+
 		// Getting the memory page size depending on the platform.
 		static size_t GetMemoryPageSize();
 
-		// Retrieves a non-writable memory page from the system.
-		static MemoryPage* CatchPage(size_t pageSize);
+		// Getting the huge memory page size depending on the platform (the usual page size if there are no huge pages).
+		static size_t GetHugeMemoryPageSize();
+
+		// Reserves a region of addresses aligned to the page size without any memory behind it.
+		static void* ReserveRegion(size_t regionSize, size_t pageSize);
 
-		// Releases a page of memory into the system.
+		// Retrieves a non-writable memory page from the system at the address inside a reserved region.
+		static MemoryPage* CatchPage(void* startAddress, size_t pageSize);
+
+		// Releases a page of memory into the system, keeping its addresses reserved.
 		static void FreePage(MemoryPage* page);
 
+		// Retrieves non-writable memory for the whole run of addresses at once, faulting it in right away.
+		static void PopulateRegion(void* startAddress, size_t regionSize);
+
+		// Lets the system take the memory of the page when it runs short, while the page stays usable.
+		static void DiscardPage(MemoryPage* page);
+
+		// Retrieves non-writable memory for the reserved addresses right after the page, making the page larger in place.
+		static void ExtendPage(MemoryPage* page, size_t pageSize);
+
+		// Moves the memory of the page to a larger run of reserved addresses (without copying where the system can), leaving the old addresses reserved.
+		static void MovePage(MemoryPage* page, void* startAddress, size_t pageSize);
+
 		// Closes the memory page for recording.
 		static void LockPage(MemoryPage* page);
 
 		// Opens the memory page for recording.
 		static void UnlockPage(MemoryPage* page);
+
+		// Maps the whole file into memory for reading only, sharing its pages with other processes.
+		static void* MapFile(const string& path, size_t& fileSize);
+
+		// Removes the mapping of the file from memory.
+		static void UnmapFile(void* startAddress, size_t fileSize);
+
+		// Address of the same memory in the writable alias (there is no alias here, so it is never called).
+		static void* GetWritableAddress(void* address);
 	};
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace immutable::internals
+{
+	// Allocator entry points written to the trace.
+	enum class TraceOperation : uint32_t
+	{
+		// Memory was allocated.
+		Allocate,
+
+		// Objects were initialized.
+		Construct,
+
+		// Objects were deinitialized.
+		Destroy,
+
+		// Memory was freed.
+		Deallocate
+	};
+
+	// A single call of the allocator as it is written to the trace file.
+	class TraceRecord
+	{
+	public:
+		// Time of the call since the start of the recording.
+		uint64_t Nanoseconds;
+
+		// Address of the first object.
+		uint64_t Address;
+
+		// Size of a single object.
+		uint32_t Size;
+
+		// Count of objects.
+		uint32_t Count;
+
+		// Number of the calling thread in the order of their first calls.
+		uint32_t Thread;
+
+		// The called entry point.
+		TraceOperation Operation;
+	};
+
+	// Information at the beginning of every trace file.
+	class TraceHeader
+	{
+	public:
+		// A mark of the trace file format.
+		uint64_t Signature;
+
+		// A version of the trace file format.
+		uint64_t Version;
+	};
+
+	// Recorder of allocator calls into a binary file, buffering them per thread so that the calls never wait for the file.
+	class TraceRecorder
+	{
+	public:
+		// A sign that the calls are recorded (checked by the allocator before every record).
+		static inline atomic<bool> IsRecording = false;
+
+		// Opens the file and starts recording the calls of all threads into it.
+		static void Start(const string& path);
+
+		// Writes the calls left in the buffers and closes the file.
+		static void Stop();
+
+		// Puts the call into the buffer of the calling thread.
+		static void Record(TraceOperation operation, const void* address, size_t size, size_t count);
+
+		// Reads all calls from the trace file and checks its header.
+		static vector<TraceRecord> Load(const string& path);
+
+	private:
+		// Calls of a single thread waiting to be written.
+		class ThreadBuffer
+		{
+		public:
+			// An object for synchronizing the thread with writing its calls when the recording stops.
+			mutex Mutex;
+
+			// Number of the thread in the trace.
+			uint32_t Thread;
+
+			// Calls not yet written.
+			vector<TraceRecord> Records;
+		};
+
+		// A mark of the trace file format ("IMMTRACE").
+		static constexpr uint64_t FormatSignature = 0x45434152544D4D49;
+
+		// A version of the trace file format.
+		static constexpr uint64_t FormatVersion = 1;
+
+		// Count of calls a thread buffers before writing them.
+		static constexpr size_t BufferSize = 4096;
+
+		// An object for synchronizing work with the file and the list of buffers.
+		static inline mutex FileMutex;
+
+		// The file of the current recording.
+		static inline ofstream File;
+
+		// The moment the current recording started.
+		static inline chrono::steady_clock::time_point StartTime;
+
+		// Buffers of every thread that has recorded calls (a buffer outlives its thread until the recording stops).
+		static inline list<shared_ptr<ThreadBuffer>> Buffers;
+
+		// Number of the next thread that records its first call.
+		static inline uint32_t NextThread = 0;
+
+		// The buffer of the calling thread, registered on its first call.
+		static ThreadBuffer& GetThreadBuffer();
+
+		// Writes the calls of the buffer to the file and empties it (the buffer must be locked).
+		static void WriteBuffer(ThreadBuffer& buffer);
+	};
+};
\ No newline at end of file
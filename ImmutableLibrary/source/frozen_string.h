@@ -0,0 +1,93 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	inline FrozenString::FrozenString()
+	{
+	};
+
+	inline FrozenString::FrozenString(string_view value)
+	{
+		if (value.empty())
+			return;
+		// the terminating null is frozen together with the characters straight from the view
+		Characters = FrozenVector<char>(TerminatedIterator(value, 0), TerminatedIterator(value, value.size() + 1));
+	};
+
+	inline const char* FrozenString::data() const
+	{
+		return c_str();
+	};
+
+	inline const char* FrozenString::c_str() const
+	{
+		return Characters.empty() ? "" : Characters.data();
+	};
+
+	inline size_t FrozenString::size() const
+	{
+		return Characters.empty() ? 0 : Characters.size() - 1;
+	};
+
+	inline bool FrozenString::empty() const
+	{
+		return size() == 0;
+	};
+
+	inline const char& FrozenString::operator[](size_t index) const
+	{
+		return c_str()[index];
+	};
+
+	inline const char* FrozenString::begin() const
+	{
+		return c_str();
+	};
+
+	inline const char* FrozenString::end() const
+	{
+		return c_str() + size();
+	};
+
+	inline FrozenString::operator string_view() const
+	{
+		return string_view(c_str(), size());
+	};
+
+	inline bool FrozenString::operator==(string_view other) const
+	{
+		return string_view(*this) == other;
+	};
+
+	inline FrozenString::TerminatedIterator::TerminatedIterator(string_view value, size_t index)
+	{
+		Value = value;
+		Index = index;
+	};
+
+	inline const char& FrozenString::TerminatedIterator::operator*() const
+	{
+		static constexpr char terminator = '\0';
+		return Index < Value.size() ? Value[Index] : terminator;
+	};
+
+	inline FrozenString::TerminatedIterator& FrozenString::TerminatedIterator::operator++()
+	{
+		++Index;
+		return *this;
+	};
+
+	inline FrozenString::TerminatedIterator FrozenString::TerminatedIterator::operator++(int)
+	{
+		auto previous = *this;
+		++Index;
+		return previous;
+	};
+
+	inline bool FrozenString::TerminatedIterator::operator==(const TerminatedIterator& other) const
+	{
+		return Index == other.Index;
+	};
+};
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	template<class T> FrozenVector<T>::FrozenVector()
+	{
+		Elements = nullptr;
+		Count = 0;
+	};
+
+	template<class T> template<class ForwardIt> FrozenVector<T>::FrozenVector(ForwardIt first, ForwardIt last)
+	{
+		Elements = nullptr;
+		Count = (size_t)distance(first, last);
+		if (Count == 0)
+			return;
+		Elements = ImmutableAllocator<T>::allocate(Count);
+		FreezeElements(first);
+	};
+
+	template<class T> FrozenVector<T>::FrozenVector(initializer_list<T> values) : FrozenVector(values.begin(), values.end())
+	{
+	};
+
+	template<class T> FrozenVector<T>::FrozenVector(vector<T>&& values) : FrozenVector(make_move_iterator(values.begin()), make_move_iterator(values.end()))
+	{
+	};
+
+	template<class T> FrozenVector<T>::FrozenVector(const FrozenVector& other) : FrozenVector(other.begin(), other.end())
+	{
+	};
+
+	template<class T> FrozenVector<T>::FrozenVector(FrozenVector&& other) noexcept
+	{
+		Elements = other.Elements;
+		Count = other.Count;
+		other.Elements = nullptr;
+		other.Count = 0;
+	};
+
+	template<class T> FrozenVector<T>& FrozenVector<T>::operator=(FrozenVector other) noexcept
+	{
+		swap(Elements, other.Elements);
+		swap(Count, other.Count);
+		return *this;
+	};
+
+	template<class T> FrozenVector<T>::~FrozenVector()
+	{
+		if (Elements == nullptr)
+			return;
+		ImmutableAllocator<T>::destroy_n(Elements, Count);
+		ImmutableAllocator<T>::deallocate(Elements, Count);
+	};
+
+	template<class T> const T* FrozenVector<T>::data() const
+	{
+		return Elements;
+	};
+
+	template<class T> size_t FrozenVector<T>::size() const
+	{
+		return Count;
+	};
+
+	template<class T> bool FrozenVector<T>::empty() const
+	{
+		return Count == 0;
+	};
+
+	template<class T> const T& FrozenVector<T>::operator[](size_t index) const
+	{
+		return Elements[index];
+	};
+
+	template<class T> typename FrozenVector<T>::const_iterator FrozenVector<T>::begin() const
+	{
+		return Elements;
+	};
+
+	template<class T> typename FrozenVector<T>::const_iterator FrozenVector<T>::end() const
+	{
+		return Elements + Count;
+	};
+
+	template<class T> FrozenVector<T>::operator span<const T>() const
+	{
+		return span<const T>(Elements, Count);
+	};
+
+	template<class T> template<class ForwardIt> void FrozenVector<T>::FreezeElements(ForwardIt first)
+	{
+		size_t constructedCount = 0;
+		// safe fill the elements so don't end up with half of the objects in case of an error
+		try
+		{
+			ImmutableBatch batch;
+			for (; constructedCount < Count; ++constructedCount, ++first)
+				ImmutableAllocator<T>::construct(Elements + constructedCount, *first);
+		}
+		catch (...)
+		{
+			if (constructedCount != 0)
+				ImmutableAllocator<T>::destroy_n(Elements, constructedCount);
+			ImmutableAllocator<T>::deallocate(Elements, Count);
+			throw;
+		}
+	};
+};
\ No newline at end of file
@@ -1,183 +1,702 @@
 #pragma once
 
-#include "..\headers\immutable.h"
+#include "../headers/immutable.h"
 
 namespace immutable
 {
-	template<class T> T* ImmutableAllocator<T>::allocate(size_t count_objects)
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> T* BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::allocate(size_t count_objects)
 	{
-		// a stub for allocating memory for std container's internals
+#ifdef _MSC_VER
+		// a stub for allocating memory for std container's internals (only the MSVC library has them)
 		if (typeid(T) == typeid(_Container_proxy))
 			return (T*)malloc(sizeof(T) * count_objects);
-		// regular memory allocation by allocator
-		const lock_guard<mutex> guard(ImmutableData::Mutex);
-		auto firstCatchedBlock = CatchBlocksAndReturnFirst(sizeof(T), count_objects);
-		return (T*)(firstCatchedBlock->StartAddress);
+#endif
+		// pages are the largest unit that is aligned, so over-aligned types cannot be placed beyond them
+		constexpr auto wrongAlignment = "Alignment is not a power of two or is larger than the page.";
+		if (alignof(T) > PageSourcePolicy::GetPageSize())
+			throw runtime_error(wrongAlignment);
+		// regular memory allocation by allocator from the heap of the current thread
+		auto heap = PageSourcePolicy::GetThreadHeap();
+		const LockPolicy guard(heap);
+		FreeRemoteReleases(heap);
+		auto result = (T*)CatchBlocksAndReturnFirst(heap, sizeof(T), count_objects, alignof(T));
+		RecordCall(TraceOperation::Allocate, result, sizeof(T), count_objects);
+		return result;
 	};
 
-	template<class T> template<class U, class... Args> void ImmutableAllocator<T>::construct(U* p, Args&&... args)
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> T* BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::allocate(size_t count_objects, align_val_t alignment)
+	{
+		constexpr auto wrongAlignment = "Alignment is not a power of two or is larger than the page.";
+		auto alignmentSize = max((size_t)alignment, alignof(T));
+		if (!has_single_bit(alignmentSize) || alignmentSize > PageSourcePolicy::GetPageSize())
+			throw runtime_error(wrongAlignment);
+		auto heap = PageSourcePolicy::GetThreadHeap();
+		const LockPolicy guard(heap);
+		FreeRemoteReleases(heap);
+		auto result = (T*)CatchBlocksAndReturnFirst(heap, sizeof(T), count_objects, alignmentSize);
+		RecordCall(TraceOperation::Allocate, result, sizeof(T), count_objects);
+		return result;
+	};
+
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> T* BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::AllocateInCacheLine(size_t count_objects)
+	{
+		// a block no larger than a line never crosses one when it starts at a multiple of its size rounded up to a power of two
+		auto totalSize = sizeof(T) * count_objects;
+		return allocate(count_objects, align_val_t(min(bit_ceil(max<size_t>(totalSize, 1)), ImmutableData::CacheLineSize)));
+	};
+
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> ImmutableAllocationResult<T> BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::allocate_at_least(size_t count_objects)
+	{
+		constexpr auto wrongAlignment = "Alignment is not a power of two or is larger than the page.";
+		if (alignof(T) > PageSourcePolicy::GetPageSize())
+			throw runtime_error(wrongAlignment);
+		auto heap = PageSourcePolicy::GetThreadHeap();
+		const LockPolicy guard(heap);
+		FreeRemoteReleases(heap);
+		auto result = (T*)CatchBlocksAndReturnFirst(heap, sizeof(T), count_objects, alignof(T));
+		// small objects share their pages, so only objects taking more than a page get the free slots after them
+		if (sizeof(T) * count_objects < PageSourcePolicy::GetPageSize())
+		{
+			RecordCall(TraceOperation::Allocate, result, sizeof(T), count_objects);
+			return { result, count_objects };
+		}
+		auto page = FindMemoryPage(result);
+		auto endSlot = (size_t)((char*)result - (char*)page->StartAddress) / page->SlotSize + count_objects;
+		auto extraCount = (size_t)0;
+		while (endSlot + extraCount < page->SlotsCount && page->AreSlotsFree(endSlot + extraCount, 1))
+			++extraCount;
+		page->CatchSlots(endSlot, extraCount);
+		page->BlocksCount += extraCount;
+		heap->Statistics.LiveBlocks.Add(extraCount);
+		heap->Statistics.LiveBytes.Add(sizeof(T) * extraCount);
+		if (page->BlocksCount == page->SlotsCount)
+			RemoveMemoryPageFromCache(heap, page);
+		RecordCall(TraceOperation::Allocate, result, sizeof(T), count_objects + extraCount);
+		return { result, count_objects + extraCount };
+	};
+
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> T* BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::Reallocate(T* ptr, size_t count_objects, size_t new_count_objects)
+	{
+		static_assert(is_trivially_copyable_v<T>, "Only plain objects can be moved without constructing them again.");
+		if (new_count_objects <= count_objects)
+			return ptr;
+		auto page = FindMemoryPage(ptr);
+		auto heap = PageSourcePolicy::GetThreadHeap();
+		if (page->OwnerHeap == heap)
+		{
+			const LockPolicy guard(heap);
+			auto firstSlot = FindMemoryBlocksAndReturnFirstSlot(page, ptr, sizeof(T), count_objects);
+			auto result = (firstSlot == 0) ? GrowMemoryPage(heap, page, count_objects, new_count_objects) : nullptr;
+			if (result != nullptr)
+				return result;
+		}
+
+		// otherwise the objects are copied to new memory, taking their initialization along
+		auto result = allocate(new_count_objects);
+		auto targetPage = FindMemoryPage(result);
+		vector<bool> initializedSlots(count_objects);
+		{
+			const LockPolicy guard(page->OwnerHeap);
+			auto firstSlot = FindMemoryBlocksAndReturnFirstSlot(page, ptr, sizeof(T), count_objects);
+			for (size_t i = 0; i < count_objects; ++i)
+				initializedSlots[i] = page->IsSlotInitialized(firstSlot + i);
+		}
+		{
+			const LockPolicy guard(targetPage->OwnerHeap);
+			OpenPage(targetPage);
+		}
+		memcpy((void*)result, (const void*)ptr, sizeof(T) * count_objects);
+		{
+			const LockPolicy guard(targetPage->OwnerHeap);
+			auto firstSlot = FindMemoryBlocksAndReturnFirstSlot(targetPage, result, sizeof(T), new_count_objects);
+			for (size_t i = 0; i < count_objects; ++i)
+				targetPage->SetSlotInitialized(firstSlot + i, initializedSlots[i]);
+			ClosePageOrKeepInBatch(targetPage);
+		}
+		{
+			const LockPolicy guard(page->OwnerHeap);
+			auto firstSlot = FindMemoryBlocksAndReturnFirstSlot(page, ptr, sizeof(T), count_objects);
+			for (size_t i = 0; i < count_objects; ++i)
+				page->SetSlotInitialized(firstSlot + i, false);
+		}
+		deallocate(ptr, count_objects);
+		return result;
+	};
+
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> template<class U, class... Args> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::construct(U* p, Args&&... args)
 	{
 		static_assert(is_constructible_v<U, Args...>, "The required constructor was not found.");
-		const lock_guard<mutex> guard(ImmutableData::Mutex);
-		auto firstFoundBlock = FindMemoryBlocksAndReturnFirst(p, sizeof(U), 1);
+		RecordCall(TraceOperation::Construct, p, sizeof(U), 1);
+		auto page = FindMemoryPage(p);
 		constexpr auto alreadyInitialized = "Memory block is already initialized.";
-		if (firstFoundBlock->IsInitialized)
-			throw runtime_error(alreadyInitialized);
-		MemoryProtector::UnlockPage(firstFoundBlock->OwnerPage);
-		// safe call the constructor so don't end up with an unlocked page in case of an error
+		// a plain object is built aside and copied through the writable alias, so its page is never opened
+		if constexpr (ProtectPolicy::HasWritableAlias && is_trivially_copyable_v<U>)
+		{
+			auto value = U(forward<Args>(args)...);
+			const LockPolicy guard(page->OwnerHeap);
+			auto slot = FindMemoryBlocksAndReturnFirstSlot(page, p, sizeof(U), 1);
+			if (page->IsSlotInitialized(slot))
+				throw runtime_error(alreadyInitialized);
+			memcpy(ProtectPolicy::GetWritableAddress(p), &value, sizeof(U));
+			page->SetSlotInitialized(slot, true);
+			return;
+		}
+		size_t slot;
+		{
+			const LockPolicy guard(page->OwnerHeap);
+			slot = FindMemoryBlocksAndReturnFirstSlot(page, p, sizeof(U), 1);
+			if (page->IsSlotInitialized(slot))
+				throw runtime_error(alreadyInitialized);
+			OpenPage(page);
+		}
+		// the constructor runs without the heap lock, since it may use the allocator itself (the page stays open meanwhile)
 		try
 		{
 			construct_at<U>(p, forward<Args>(args)...);
-			MemoryProtector::LockPage(firstFoundBlock->OwnerPage);
 		}
 		catch (...)
 		{
-			MemoryProtector::LockPage(firstFoundBlock->OwnerPage);
+			const LockPolicy guard(page->OwnerHeap);
+			ClosePage(page);
 			throw;
 		}
 		// set the memory block initialization to prevent repeated initialization in future
-		firstFoundBlock->IsInitialized = true;
+		const LockPolicy guard(page->OwnerHeap);
+		page->SetSlotInitialized(slot, true);
+		ClosePageOrKeepInBatch(page);
 	};
 
-	template<class T> template<class U> void ImmutableAllocator<T>::destroy(U* p)
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> template<class U> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::destroy(U* p)
 	{
-		const lock_guard<mutex> guard(ImmutableData::Mutex);
-		auto firstFoundBlock = FindMemoryBlocksAndReturnFirst(p, sizeof(U), 1);
-		constexpr auto notInitialized = "Memory block is not deinitialized.";
-		if (!firstFoundBlock->IsInitialized)
-			throw runtime_error(notInitialized);
-		MemoryProtector::UnlockPage(firstFoundBlock->OwnerPage);
-		// safe call the destructor so don't end up with an unlocked page in case of an error
+		RecordCall(TraceOperation::Destroy, p, sizeof(U), 1);
+		auto page = FindMemoryPage(p);
+		size_t slot;
+		{
+			const LockPolicy guard(page->OwnerHeap);
+			slot = FindMemoryBlocksAndReturnFirstSlot(page, p, sizeof(U), 1);
+			constexpr auto notInitialized = "Memory block is not deinitialized.";
+			if (!page->IsSlotInitialized(slot))
+				throw runtime_error(notInitialized);
+			// a trivial destructor writes nothing, so there is no need to open the page
+			if constexpr (is_trivially_destructible_v<U>)
+			{
+				page->SetSlotInitialized(slot, false);
+				return;
+			}
+			OpenPage(page);
+		}
+		// the destructor runs without the heap lock, since it may use the allocator itself (the page stays open meanwhile)
 		try
 		{
 			destroy_at<U>(p);
-			MemoryProtector::LockPage(firstFoundBlock->OwnerPage);
 		}
 		catch (...)
 		{
-			MemoryProtector::LockPage(firstFoundBlock->OwnerPage);
+			const LockPolicy guard(page->OwnerHeap);
+			ClosePage(page);
 			throw;
 		}
 		// set the memory block deinitialization to prevent repeated destruction in future
-		firstFoundBlock->IsInitialized = false;
+		const LockPolicy guard(page->OwnerHeap);
+		page->SetSlotInitialized(slot, false);
+		ClosePageOrKeepInBatch(page);
 	}
 
-	template<class T> void ImmutableAllocator<T>::deallocate(T* ptr, size_t count_objects)
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::deallocate(T* ptr, size_t count_objects)
 	{
-		// a stub for deallocating memory for std container's internals
+#ifdef _MSC_VER
+		// a stub for deallocating memory for std container's internals (only the MSVC library has them)
 		if (typeid(T) == typeid(_Container_proxy))
 			return free(ptr);
-		// regular memory deallocation by allocator
-		const lock_guard<mutex> guard(ImmutableData::Mutex);
-		auto firstFoundBlock = FindMemoryBlocksAndReturnFirst(ptr, sizeof(T), count_objects);
-		FreeBlocks(ptr, sizeof(T), count_objects);
+#endif
+		RecordCall(TraceOperation::Deallocate, ptr, sizeof(T), count_objects);
+		// regular memory deallocation by allocator on the thread that owns the heap
+		auto page = FindMemoryPage(ptr);
+		auto heap = page->OwnerHeap;
+		if (heap == PageSourcePolicy::GetThreadHeap())
+		{
+			const LockPolicy guard(heap);
+			FreeBlocks(page, ptr, sizeof(T), count_objects);
+			FreeRemoteReleases(heap);
+			return;
+		}
+		// blocks of another thread are only checked here and then freed by the owner on its next call
+		const shared_lock<shared_mutex> guard(heap->Mutex);
+		auto firstSlot = FindMemoryBlocksAndReturnFirstSlot(page, ptr, sizeof(T), count_objects);
+		constexpr auto notDeinitialized = "Specified block is not deinitializes.";
+		if (page->IsAnySlotInitialized(firstSlot, count_objects))
+			throw runtime_error(notDeinitialized);
+		heap->PushRemoteRelease(new RemoteRelease(ptr, sizeof(T), count_objects));
 	};
 
-	template<class T> MemoryBlock* ImmutableAllocator<T>::CatchBlocksAndReturnFirst(size_t blockSize, size_t blockCount)
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> size_t BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::VerifySealedPages()
 	{
-		auto totalBlockSize = blockSize * blockCount;
-		auto targetPagePosition = FindMemoryPagePositionWithEnoughSpace(totalBlockSize);
-		MemoryPage* targetPage = nullptr;
-		MemoryBlock* firstCatchedBlock = nullptr;
+		if constexpr (!ProtectPolicy::HasChecksums)
+			return 0;
+		else
+		{
+			auto heap = PageSourcePolicy::GetThreadHeap();
+			const LockPolicy guard(heap);
+			size_t changedPages = 0;
+			// pages open for writing have no checksum yet, they are checked when sealed and opened again
+			for (auto page : heap->UsedPages)
+				if (page->UnlockCount == 0 && !ProtectPolicy::VerifyPage(page))
+					++changedPages;
+			return changedPages;
+		}
+	};
 
-		if (targetPagePosition == ImmutableData::MemoryPages.end())
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> template<class U, class... Args> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::construct_n(U* p, size_t count_objects, Args&&... args)
+	{
+		static_assert(is_constructible_v<U, Args&...>, "The required constructor was not found.");
+		RecordCall(TraceOperation::Construct, p, sizeof(U), count_objects);
+		auto page = FindMemoryPage(p);
+		constexpr auto alreadyInitialized = "Memory block is already initialized.";
+		// plain objects are built aside and copied through the writable alias, so the page is never opened
+		if constexpr (ProtectPolicy::HasWritableAlias && is_trivially_copyable_v<U>)
 		{
-			auto systemPageSize = ImmutableData::SystemPageSize;
-			auto pageSize = ((totalBlockSize % systemPageSize == 0) ? totalBlockSize : (((totalBlockSize / systemPageSize) + 1) * systemPageSize));
-			targetPage = MemoryProtector::CatchPage(pageSize);
+			size_t firstSlot;
+			{
+				const LockPolicy guard(page->OwnerHeap);
+				firstSlot = FindMemoryBlocksAndReturnFirstSlot(page, p, sizeof(U), count_objects);
+				if (page->IsAnySlotInitialized(firstSlot, count_objects))
+					throw runtime_error(alreadyInitialized);
+			}
+			auto alias = (U*)ProtectPolicy::GetWritableAddress(p);
+			// copies have trivial destructors, so there is nothing to roll back in case of an error
+			for (size_t i = 0; i < count_objects; ++i)
+			{
+				auto value = U(args...);
+				memcpy(alias + i, &value, sizeof(U));
+			}
+			const LockPolicy guard(page->OwnerHeap);
+			for (size_t i = 0; i < count_objects; ++i)
+				page->SetSlotInitialized(firstSlot + i, true);
+			return;
 		}
-		else
+		size_t firstSlot;
+		{
+			const LockPolicy guard(page->OwnerHeap);
+			firstSlot = FindMemoryBlocksAndReturnFirstSlot(page, p, sizeof(U), count_objects);
+			if (page->IsAnySlotInitialized(firstSlot, count_objects))
+				throw runtime_error(alreadyInitialized);
+			OpenPage(page);
+		}
+		// safe call the constructors without the heap lock so don't end up with an unlocked page or half of the objects in case of an error
+		size_t constructedCount = 0;
+		try
 		{
-			targetPage = (*targetPagePosition);
-			ImmutableData::MemoryPages.erase(targetPagePosition);
+			for (; constructedCount < count_objects; ++constructedCount)
+				construct_at<U>(p + constructedCount, args...);
 		}
+		catch (...)
+		{
+			for (size_t i = 0; i < constructedCount; ++i)
+				destroy_at<U>(p + i);
+			const LockPolicy guard(page->OwnerHeap);
+			ClosePage(page);
+			throw;
+		}
+		// set the memory blocks initialization to prevent repeated initialization in future
+		const LockPolicy guard(page->OwnerHeap);
+		for (size_t i = 0; i < count_objects; ++i)
+			page->SetSlotInitialized(firstSlot + i, true);
+		ClosePageOrKeepInBatch(page);
+	};
 
-		for (size_t i = 0; i < blockCount; ++i)
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> template<class U> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::destroy_n(U* p, size_t count_objects)
+	{
+		RecordCall(TraceOperation::Destroy, p, sizeof(U), count_objects);
+		auto page = FindMemoryPage(p);
+		size_t firstSlot;
+		{
+			const LockPolicy guard(page->OwnerHeap);
+			firstSlot = FindMemoryBlocksAndReturnFirstSlot(page, p, sizeof(U), count_objects);
+			constexpr auto notInitialized = "Memory block is not deinitialized.";
+			for (size_t i = 0; i < count_objects; ++i)
+				if (!page->IsSlotInitialized(firstSlot + i))
+					throw runtime_error(notInitialized);
+			// trivial destructors write nothing, so there is no need to open the page
+			if constexpr (is_trivially_destructible_v<U>)
+			{
+				for (size_t i = 0; i < count_objects; ++i)
+					page->SetSlotInitialized(firstSlot + i, false);
+				return;
+			}
+			OpenPage(page);
+		}
+		// safe call the destructors without the heap lock so don't end up with an unlocked page in case of an error
+		size_t destroyedCount = 0;
+		try
 		{
-			auto block = new MemoryBlock((char*)targetPage->StartAddress + targetPage->FillOffset, blockSize, targetPage);
-			targetPage->FillOffset += blockSize;
-			if (firstCatchedBlock == nullptr)
-				firstCatchedBlock = block;
-			ImmutableData::MemoryBlocks[block->StartAddress] = block;
+			for (; destroyedCount < count_objects; ++destroyedCount)
+				destroy_at<U>(p + destroyedCount);
 		}
+		catch (...)
+		{
+			const LockPolicy guard(page->OwnerHeap);
+			for (size_t i = 0; i < destroyedCount; ++i)
+				page->SetSlotInitialized(firstSlot + i, false);
+			ClosePage(page);
+			throw;
+		}
+		const LockPolicy guard(page->OwnerHeap);
+		for (size_t i = 0; i < count_objects; ++i)
+			page->SetSlotInitialized(firstSlot + i, false);
+		ClosePageOrKeepInBatch(page);
+	};
 
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> void* BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::CatchBlocksAndReturnFirst(MemoryHeap* heap, size_t blockSize, size_t blockCount, size_t alignment)
+	{
+		auto slotSize = GetSlotSize(blockSize, blockCount);
+		auto& cachedPages = heap->MemoryPages[slotSize];
+		MemoryPage* targetPage = nullptr;
+		size_t firstSlot = 0;
+		// pages are aligned, so a block is aligned if its first slot is a multiple of this step (one for natural alignment)
+		auto slotStep = alignment / gcd(slotSize, alignment);
+
+		// any cached page has a free slot, so naturally aligned single blocks are always taken from the first one, while runs and over-aligned blocks search only a few pages
+		size_t scannedPages = 0;
+		for (auto page : cachedPages)
+		{
+			if (scannedPages++ == ImmutableData::ScannedPagesLimit)
+				break;
+			firstSlot = page->FindFreeSlots(blockCount, slotStep);
+			if (firstSlot == page->SlotsCount)
+				continue;
+			targetPage = page;
+			break;
+		}
+
+		if (targetPage == nullptr)
+		{
+			constexpr auto arenaExhausted = "Memory arena is exhausted.";
+			auto totalBlockSize = slotSize * blockCount;
+			auto minPageSize = PageSourcePolicy::GetPageSize();
+			auto pageSize = ((totalBlockSize % minPageSize == 0) ? totalBlockSize : (((totalBlockSize / minPageSize) + 1) * minPageSize));
+			// a retained page is already taken from the system and locked, so it costs no system calls at all
+			targetPage = TakeRetainedPage(heap, pageSize);
+			if (targetPage == nullptr)
+			{
+				auto pageAddress = PageSourcePolicy::GetArena().CatchRun(pageSize);
+				if (pageAddress == nullptr)
+					throw runtime_error(arenaExhausted);
+				try
+				{
+					targetPage = ProtectPolicy::CatchPage(pageAddress, pageSize);
+				}
+				catch (...)
+				{
+					PageSourcePolicy::GetArena().FreeRun(pageAddress, pageSize);
+					throw;
+				}
+				targetPage->OwnerHeap = heap;
+				heap->Statistics.MapCalls.Add(1);
+				heap->Statistics.LivePages.Add(1);
+				RaiseEvent(ImmutableEvent::PageCaught, targetPage);
+			}
+			targetPage->FormatSlots(slotSize);
+			PageSourcePolicy::GetArena().BindPage(targetPage);
+			heap->UsedPages.insert(targetPage);
+			InsertMemoryPageInCache(heap, targetPage);
+			firstSlot = 0;
+			heap->Statistics.WastedTailBytes.Add(targetPage->TotalSize - targetPage->SlotsCount * targetPage->SlotSize);
+		}
+
+		targetPage->CatchSlots(firstSlot, blockCount);
 		targetPage->BlocksCount += blockCount;
-		InsertMemoryPageInCache(targetPage);
-		return firstCatchedBlock;
+		heap->Statistics.LiveBlocks.Add(blockCount);
+		heap->Statistics.LiveBytes.Add(blockSize * blockCount);
+		heap->Statistics.CountAllocation(blockSize * blockCount);
+		if (targetPage->BlocksCount == targetPage->SlotsCount)
+			RemoveMemoryPageFromCache(heap, targetPage);
+		return (char*)targetPage->StartAddress + firstSlot * slotSize;
 	};
 
-	template<class T> void ImmutableAllocator<T>::FreeBlocks(void* startAddress, size_t blockSize, size_t blockCount)
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> constexpr size_t BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::GetSlotSize(size_t blockSize, size_t blockCount)
 	{
-		constexpr auto notDeinitialized = "Specified block is not deinitializes.";
-		MemoryPage* page = nullptr;
+		if (blockCount != 1 || blockSize > ImmutableData::LargestSizeClass)
+			return blockSize;
+		if (blockSize <= 16)
+			return (blockSize <= 8) ? 8 : 16;
+		// four classes between neighbouring powers of two keep the loss under a quarter of the block, and a class keeps the alignment of any block it holds
+		auto step = bit_floor(blockSize - 1) / 4;
+		return (blockSize + step - 1) / step * step;
+	};
 
-		for (size_t i = 0; i < blockCount; ++i)
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> T* BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::GrowMemoryPage(MemoryHeap* heap, MemoryPage* page, size_t blockCount, size_t newBlockCount)
+	{
+		// the page can only change its memory when no one else has blocks on it (an open page with checksums has none yet to check it against)
+		// a single block may sit in a slot of its size class, whose stride does not fit a sequence
+		if (page->SlotSize != sizeof(T) || page->BlocksCount != blockCount || !page->AreSlotsCatched(0, blockCount) || !page->ReferenceCounts.empty())
+			return nullptr;
+		if (ProtectPolicy::HasChecksums && page->UnlockCount != 0)
+			return nullptr;
+
+		auto& arena = PageSourcePolicy::GetArena();
+		if (newBlockCount > page->SlotsCount)
 		{
-			auto search = ImmutableData::MemoryBlocks.find(startAddress);
-			if (search->second->IsInitialized)
-				throw runtime_error(notDeinitialized);
-			if (page == nullptr)
-				page = search->second->OwnerPage;
-			delete search->second;
-			ImmutableData::MemoryBlocks.erase(startAddress);
-			startAddress = (char*)startAddress + blockSize;
+			auto minPageSize = PageSourcePolicy::GetPageSize();
+			auto totalBlockSize = page->SlotSize * newBlockCount;
+			auto pageSize = ((totalBlockSize % minPageSize == 0) ? totalBlockSize : (((totalBlockSize / minPageSize) + 1) * minPageSize));
+			// compressed contents describe the page as it was, so they are brought back and dropped first
+			if (page->Temperature.load(memory_order_acquire) != PageTemperature::Warm)
+				ImmutableColdPages::Restore(page);
+			page->CompressedContents.reset();
+			auto oldAddress = page->StartAddress;
+			auto oldSize = page->TotalSize;
+			heap->Statistics.WastedTailBytes.Subtract(page->TotalSize - page->SlotsCount * page->SlotSize);
+			RaiseEvent(ImmutableEvent::PageFreed, page);
+			arena.UnbindPage(page);
+			try
+			{
+				// the addresses right after the page are the cheapest, since nothing moves at all
+				if (arena.CatchRunAt((char*)oldAddress + oldSize, pageSize - oldSize))
+				{
+					try
+					{
+						ProtectPolicy::ExtendPage(page, pageSize);
+					}
+					catch (...)
+					{
+						arena.FreeRun((char*)oldAddress + oldSize, pageSize - oldSize);
+						throw;
+					}
+				}
+				else
+				{
+					constexpr auto arenaExhausted = "Memory arena is exhausted.";
+					auto pageAddress = arena.CatchRun(pageSize);
+					if (pageAddress == nullptr)
+						throw runtime_error(arenaExhausted);
+					try
+					{
+						ProtectPolicy::MovePage(page, pageAddress, pageSize);
+					}
+					catch (...)
+					{
+						arena.FreeRun(pageAddress, pageSize);
+						throw;
+					}
+					arena.FreeRun(oldAddress, oldSize);
+				}
+			}
+			catch (...)
+			{
+				arena.BindPage(page);
+				heap->Statistics.WastedTailBytes.Add(page->TotalSize - page->SlotsCount * page->SlotSize);
+				throw;
+			}
+			// new memory comes sealed, so a page kept open in a batch is opened again as a whole
+			if (page->UnlockCount != 0)
+				ProtectPolicy::UnlockPage(page);
+			page->ExtendSlots();
+			arena.BindPage(page);
+			heap->Statistics.MapCalls.Add(1);
+			heap->Statistics.WastedTailBytes.Add(page->TotalSize - page->SlotsCount * page->SlotSize);
+			RaiseEvent(ImmutableEvent::PageCaught, page);
 		}
+		else if (!page->AreSlotsFree(blockCount, newBlockCount - blockCount))
+			return nullptr;
+
+		page->CatchSlots(blockCount, newBlockCount - blockCount);
+		page->BlocksCount = newBlockCount;
+		heap->Statistics.LiveBlocks.Add(newBlockCount - blockCount);
+		heap->Statistics.LiveBytes.Add(page->SlotSize * (newBlockCount - blockCount));
+		if (page->BlocksCount == page->SlotsCount)
+			RemoveMemoryPageFromCache(heap, page);
+		else if (!page->IsCached)
+			InsertMemoryPageInCache(heap, page);
+		return (T*)page->StartAddress;
+	};
 
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::FreeBlocks(MemoryPage* page, void* startAddress, size_t blockSize, size_t blockCount)
+	{
+		constexpr auto notDeinitialized = "Specified block is not deinitializes.";
+		auto firstSlot = FindMemoryBlocksAndReturnFirstSlot(page, startAddress, blockSize, blockCount);
+		if (page->IsAnySlotInitialized(firstSlot, blockCount))
+			throw runtime_error(notDeinitialized);
+		page->ReleaseSlots(firstSlot, blockCount);
 		page->BlocksCount -= blockCount;
+		auto heap = page->OwnerHeap;
+		heap->Statistics.LiveBlocks.Subtract(blockCount);
+		heap->Statistics.LiveBytes.Subtract(blockSize * blockCount);
+
+		// a page still open in some batch is freed by the batch when it is sealed
+		if (page->BlocksCount == 0 && page->UnlockCount == 0)
+			FreeMemoryPage(page);
+		else if (!page->IsCached)
+			InsertMemoryPageInCache(heap, page);
+	};
 
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::OpenPage(MemoryPage* page)
+	{
+		if (page->UnlockCount == 0)
+		{
+			// compressed contents are brought back before the page changes, and after that they are of no use
+			if (page->Temperature.load(memory_order_acquire) != PageTemperature::Warm)
+				ImmutableColdPages::Restore(page);
+			page->CompressedContents.reset();
+			ProtectPolicy::UnlockPage(page);
+			page->OwnerHeap->Statistics.UnprotectCalls.Add(1);
+			RaiseEvent(ImmutableEvent::PageUnlocked, page);
+		}
+		++page->UnlockCount;
+	};
+
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::ClosePage(MemoryPage* page)
+	{
+		if (--page->UnlockCount != 0)
+			return;
+		ProtectPolicy::LockPage(page);
+		page->Touch();
+		page->OwnerHeap->Statistics.ProtectCalls.Add(1);
+		RaiseEvent(ImmutableEvent::PageLocked, page);
 		if (page->BlocksCount == 0)
+			FreeMemoryPage(page);
+	};
+
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::ClosePageOrKeepInBatch(MemoryPage* page)
+	{
+		// batches seal pages with the default policies, so pages of any other kind are sealed right away
+		if constexpr (!is_same_v<ProtectPolicy, MemoryProtector> || !is_same_v<PageSourcePolicy, ImmutableGlobalPageSource>)
 		{
-			MemoryProtector::FreePage(page);
-			ImmutableData::MemoryPages.remove(page);
-			delete page;
+			ClosePage(page);
+			return;
 		}
+		// the first time the batch meets the page it takes over the opening, later ones are just undone
+		auto batch = ImmutableData::ThreadBatch;
+		if (batch == nullptr || !batch->OpenedPages.insert(page).second)
+			ClosePage(page);
 	};
 
-	template<class T> list<MemoryPage*>::iterator ImmutableAllocator<T>::FindMemoryPagePositionWithEnoughSpace(size_t minFreeSpace)
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::FreeMemoryPage(MemoryPage* page)
 	{
-		if (ImmutableData::MemoryPages.empty())
-			return ImmutableData::MemoryPages.end();
-		if (ImmutableData::MemoryPages.back()->TotalSize - ImmutableData::MemoryPages.back()->FillOffset < minFreeSpace)
-			return ImmutableData::MemoryPages.end();
-		list<MemoryPage*>::iterator it;
-		for (it = ImmutableData::MemoryPages.begin(); it != ImmutableData::MemoryPages.end(); ++it)
-			if ((*it)->TotalSize - (*it)->FillOffset >= minFreeSpace)
-				break;
-		return it;
+		auto heap = page->OwnerHeap;
+		RemoveMemoryPageFromCache(heap, page);
+		// blocks without destructors are freed without opening the page, so it may still be cold, and its contents are of no use to anyone now
+		auto temperature = PageTemperature::Cold;
+		if (page->Temperature.compare_exchange_strong(temperature, PageTemperature::Warming, memory_order_acquire))
+		{
+			ProtectPolicy::LockPage(page);
+			page->Temperature.store(PageTemperature::Warm, memory_order_release);
+		}
+		page->CompressedContents.reset();
+		// the page is no longer found by address, so released objects cannot be touched through the allocator
+		PageSourcePolicy::GetArena().UnbindPage(page);
+		heap->UsedPages.erase(page);
+		heap->Statistics.WastedTailBytes.Subtract(page->TotalSize - page->SlotsCount * page->SlotSize);
+		if (heap->RetainedSize + page->TotalSize > ImmutableData::RetainedSizeLimit.load(memory_order_relaxed))
+			return ReturnMemoryPage(page);
+		heap->RetainedPages[page->TotalSize].push_back(page);
+		heap->RetainedSize += page->TotalSize;
+		heap->Statistics.RetainedPages.Add(1);
+	};
+
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::ReturnMemoryPage(MemoryPage* page)
+	{
+		auto heap = page->OwnerHeap;
+		ProtectPolicy::FreePage(page);
+		heap->Statistics.UnmapCalls.Add(1);
+		heap->Statistics.LivePages.Subtract(1);
+		RaiseEvent(ImmutableEvent::PageFreed, page);
+		PageSourcePolicy::GetArena().FreeRun(page->StartAddress, page->TotalSize);
+		delete page;
 	};
 
-	template<class T> MemoryBlock* ImmutableAllocator<T>::FindMemoryBlocksAndReturnFirst(void* startAddress, size_t blockSize, size_t blockCount)
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> MemoryPage* BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::TakeRetainedPage(MemoryHeap* heap, size_t pageSize)
+	{
+		auto retainedPages = heap->RetainedPages.find(pageSize);
+		if (retainedPages == heap->RetainedPages.end() || retainedPages->second.empty())
+			return nullptr;
+		// the most recently retained page is taken first, since its memory is the most likely to still be cached
+		auto page = retainedPages->second.back();
+		retainedPages->second.pop_back();
+		heap->RetainedSize -= pageSize;
+		heap->Statistics.RetainedPages.Subtract(1);
+		return page;
+	};
+
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::FreeRemoteReleases(MemoryHeap* heap)
+	{
+		auto release = heap->TakeRemoteReleases();
+		while (release != nullptr)
+		{
+			auto next = release->Next;
+			FreeBlocks(FindMemoryPage(release->StartAddress), release->StartAddress, release->BlockSize, release->BlockCount);
+			delete release;
+			release = next;
+		}
+	};
+
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> MemoryPage* BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::FindMemoryPage(void* address)
+	{
+		constexpr auto corruptedPageStatus = "Memory page status is corrupted.";
+		auto page = PageSourcePolicy::GetArena().FindPage(address);
+		if (page == nullptr)
+			throw runtime_error(corruptedPageStatus);
+		return page;
+	};
+
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> size_t BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::FindMemoryBlocksAndReturnFirstSlot(MemoryPage* page, void* startAddress, size_t blockSize, size_t blockCount)
 	{
 		constexpr auto corruptedBlockStatus = "Memory block status is corrupted.";
 		constexpr auto corruptedPageStatus = "Memory page status is corrupted.";
 
-		auto search = ImmutableData::MemoryBlocks.find(startAddress);
-		if (search == ImmutableData::MemoryBlocks.end())
+		// an object of a sequence sits in a slot of its exact size, a single block may also sit in a slot of its size class
+		if (page->SlotSize != blockSize && page->SlotSize != GetSlotSize(blockSize, blockCount))
+			throw runtime_error(corruptedBlockStatus);
+		auto offset = (size_t)((char*)startAddress - (char*)page->StartAddress);
+		auto firstSlot = offset / page->SlotSize;
+		if (offset % page->SlotSize != 0 || firstSlot + blockCount > page->SlotsCount)
+			throw runtime_error(corruptedPageStatus);
+		// the sequence is valid only if every slot of it is occupied by a block
+		if (!page->AreSlotsCatched(firstSlot, blockCount))
 			throw runtime_error(corruptedPageStatus);
-		MemoryBlock* firstFoundBlock = search->second;
-		size_t foundBlockCount = 0;
+		return firstSlot;
+	};
 
-		while (search != ImmutableData::MemoryBlocks.end())
-		{
-			if (search->second->TotalSize != blockSize)
-				throw runtime_error(corruptedBlockStatus);
-			if (++foundBlockCount == blockCount)
-				break;
-			startAddress = (char*)startAddress + blockSize;
-			search = ImmutableData::MemoryBlocks.find(startAddress);
-		}
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::InsertMemoryPageInCache(MemoryHeap* heap, MemoryPage* page)
+	{
+		auto& cachedPages = heap->MemoryPages[page->SlotSize];
+		page->CachePosition = cachedPages.insert(cachedPages.begin(), page);
+		page->IsCached = true;
+	};
 
-		if (foundBlockCount == blockCount)
-			return firstFoundBlock;
-		throw runtime_error(corruptedPageStatus);
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::RemoveMemoryPageFromCache(MemoryHeap* heap, MemoryPage* page)
+	{
+		if (!page->IsCached)
+			return;
+		heap->MemoryPages[page->SlotSize].erase(page->CachePosition);
+		page->IsCached = false;
 	};
 
-	template<class T> void ImmutableAllocator<T>::InsertMemoryPageInCache(MemoryPage* page)
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> atomic<size_t>* BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::CreateReferenceCount(T* object)
 	{
-		auto insertPagePosition = FindMemoryPagePositionWithEnoughSpace(page->TotalSize - page->FillOffset);
-		if (insertPagePosition == ImmutableData::MemoryPages.end())
-			ImmutableData::MemoryPages.push_back(page);
-		else
-			ImmutableData::MemoryPages.insert(insertPagePosition, page);
+		auto page = FindMemoryPage(object);
+		// the counters are made by the owner of the page, and the slot of a new object is not shared with anyone yet
+		const LockPolicy guard(page->OwnerHeap);
+		return page->CreateReferenceCount((size_t)((char*)object - (char*)page->StartAddress) / page->SlotSize);
+	};
+
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::ReleaseReferenceCount(T* object)
+	{
+		auto page = FindMemoryPage(object);
+		const LockPolicy guard(page->OwnerHeap);
+		page->ReleaseReferenceCount((size_t)((char*)object - (char*)page->StartAddress) / page->SlotSize);
+	};
+
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::RaiseEvent(ImmutableEvent event, MemoryPage* page)
+	{
+		auto hook = ImmutableData::EventHook.load(memory_order_acquire);
+		if (hook != nullptr)
+			hook(event, page->StartAddress, page->TotalSize);
+	};
+
+	template<class T, class LockPolicy, class ProtectPolicy, class PageSourcePolicy> void BasicImmutableAllocator<T, LockPolicy, ProtectPolicy, PageSourcePolicy>::RecordCall(TraceOperation operation, const void* address, size_t size, size_t count)
+	{
+		// a relaxed check is all the calls pay while nothing is recorded
+		if (TraceRecorder::IsRecording.load(memory_order_relaxed))
+			TraceRecorder::Record(operation, address, size, count);
 	};
 };
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	inline ImmutableBatch::ImmutableBatch()
+	{
+		PreviousBatch = ImmutableData::ThreadBatch;
+		ImmutableData::ThreadBatch = this;
+	};
+
+	inline ImmutableBatch::~ImmutableBatch()
+	{
+		Commit();
+		ImmutableData::ThreadBatch = PreviousBatch;
+	};
+
+	inline void ImmutableBatch::Commit()
+	{
+		// pages do not depend on the type of objects, so any allocator can seal them
+		for (auto page : OpenedPages)
+		{
+			const MemoryHeapLock guard(page->OwnerHeap);
+			ImmutableAllocator<char>::ClosePage(page);
+		}
+		OpenedPages.clear();
+		for (auto region : OpenedRegions)
+			region->SealBatchPages();
+		OpenedRegions.clear();
+	};
+};
\ No newline at end of file
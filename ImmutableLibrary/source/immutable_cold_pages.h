@@ -0,0 +1,124 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	// the allocator writes plain objects through the alias without opening their pages, so compressed contents could go stale there
+#if defined(__linux__) && !defined(IMMUTABLE_DUAL_MAPPING)
+	inline size_t ImmutableColdPages::Compress(chrono::steady_clock::duration age)
+	{
+		HandleFaultsOnce();
+		auto lastTouchTime = (chrono::steady_clock::now() - age).time_since_epoch().count();
+		size_t compressedCount = 0;
+		for (auto heap : MemoryHeap::GetAllHeaps())
+		{
+			// faults are found only in the global region, and heaps of other sources may not even be locked by their owners
+			if (heap->OwnerPool != &ImmutableData::HeapPool)
+				continue;
+			const MemoryHeapLock guard(heap);
+			for (auto page : heap->UsedPages)
+			{
+				// pages open for writing change, and empty ones are not worth anything
+				if (page->UnlockCount != 0 || page->BlocksCount == 0)
+					continue;
+				if (page->Temperature.load(memory_order_relaxed) != PageTemperature::Warm || page->LastTouchTime.load(memory_order_relaxed) > lastTouchTime)
+					continue;
+				if (CompressPage(page))
+					++compressedCount;
+			}
+		}
+		return compressedCount;
+	};
+
+	inline void ImmutableColdPages::HandleFaultsOnce()
+	{
+		static once_flag isHandled;
+		call_once(isHandled, []() { MemoryProtector::HandleFaults(HandleFault); });
+	};
+
+	inline bool ImmutableColdPages::HandleFault(void* address)
+	{
+		// the address and the count of restored pages at the last retry of the thread
+		static thread_local void* retriedAddress = nullptr;
+		static thread_local size_t retriedRestoredCount = 0;
+
+		auto page = ImmutableData::Arena.FindPage(address);
+		if (page == nullptr)
+			return false;
+		if (page->Temperature.load(memory_order_acquire) != PageTemperature::Warm)
+		{
+			Restore(page);
+			return true;
+		}
+		// another thread may have restored the page between the fault and now, which is only the case if some page was restored since the last retry here
+		auto restoredCount = RestoredCount.load(memory_order_acquire);
+		if (retriedAddress == address && retriedRestoredCount == restoredCount)
+			return false;
+		retriedAddress = address;
+		retriedRestoredCount = restoredCount;
+		return true;
+	};
+
+	inline bool ImmutableColdPages::CompressPage(MemoryPage* page)
+	{
+		// the contents compressed before are still valid if the page was not opened for writing since
+		if (page->CompressedContents == nullptr)
+		{
+			auto buffer = make_unique<uint8_t[]>(PageCodec::GetCompressedBound(page->TotalSize));
+			auto compressedSize = PageCodec::Compress(page->StartAddress, page->TotalSize, buffer.get());
+			if (compressedSize > page->TotalSize / 2)
+				return false;
+			page->CompressedContents = make_unique<uint8_t[]>(compressedSize);
+			memcpy(page->CompressedContents.get(), buffer.get(), compressedSize);
+			page->CompressedSize = compressedSize;
+		}
+
+		// readers faulting while the memory is being dropped wait for the page to become cold
+		page->Temperature.store(PageTemperature::Cooling, memory_order_release);
+		try
+		{
+			MemoryProtector::HidePage(page);
+		}
+		catch (...)
+		{
+			MemoryProtector::LockPage(page);
+			page->Temperature.store(PageTemperature::Warm, memory_order_release);
+			throw;
+		}
+		page->Temperature.store(PageTemperature::Cold, memory_order_release);
+		return true;
+	};
+
+	inline void ImmutableColdPages::Restore(MemoryPage* page)
+	{
+		for (;;)
+		{
+			auto temperature = page->Temperature.load(memory_order_acquire);
+			if (temperature == PageTemperature::Warm)
+				return;
+			if (temperature == PageTemperature::Cold && page->Temperature.compare_exchange_strong(temperature, PageTemperature::Warming, memory_order_acquire))
+				break;
+			// another thread is compressing or restoring the page right now
+			this_thread::yield();
+		}
+
+		// the contents are put together aside, since readers of the page must never see it half restored
+		auto scratch = MemoryProtector::MapScratch(page->TotalSize);
+		PageCodec::Decompress(page->CompressedContents.get(), page->CompressedSize, scratch);
+		MemoryProtector::ReplacePage(page, scratch);
+		page->Touch();
+		RestoredCount.fetch_add(1, memory_order_release);
+		page->Temperature.store(PageTemperature::Warm, memory_order_release);
+	};
+#else
+	inline size_t ImmutableColdPages::Compress(chrono::steady_clock::duration)
+	{
+		return 0;
+	};
+
+	inline void ImmutableColdPages::Restore(MemoryPage*)
+	{
+	};
+#endif
+};
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	template<class T> void ImmutableEpoch::Retire(T* p, size_t count_objects)
+	{
+		if (p == nullptr)
+			return;
+		if (ImmutableData::Epochs.Retire(p, count_objects, Reclaim<T>))
+			Collect();
+	};
+
+	inline size_t ImmutableEpoch::Collect()
+	{
+		auto objects = ImmutableData::Epochs.TakeReclaimable();
+		// objects retired together usually share pages, so each page is opened only once
+		ImmutableBatch batch;
+		for (auto& object : objects)
+			object.Reclaim(object.Address, object.Count);
+		return objects.size();
+	};
+
+	template<class T> void ImmutableEpoch::Reclaim(void* p, size_t count_objects)
+	{
+		ImmutableAllocator<T>::destroy_n((T*)p, count_objects);
+		ImmutableAllocator<T>::deallocate((T*)p, count_objects);
+	};
+};
\ No newline at end of file
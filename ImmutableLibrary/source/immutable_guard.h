@@ -1,14 +1,16 @@
 #pragma once
 
-#include "..\headers\immutable.h"
+#include "../headers/immutable.h"
 
 namespace immutable
 {
 	template<class T> ImmutableGuard<T>::ImmutableGuard(T* wrappedObject)
 	{
 		ImmutableAllocator<T> allocator = ImmutableAllocator<T>();
-		auto block = allocator.FindMemoryBlocksAndReturnFirst(wrappedObject, sizeof(T), 1);
-		WrappedObject = (T*)block->StartAddress;
+		auto page = allocator.FindMemoryPage(wrappedObject);
+		const shared_lock<shared_mutex> guard(page->OwnerHeap->Mutex);
+		allocator.FindMemoryBlocksAndReturnFirstSlot(page, wrappedObject, sizeof(T), 1);
+		WrappedObject = wrappedObject;
 	};
 
 	template<class T> template<class... Args> ImmutableGuard<T>::ImmutableGuard(Args&&... args)
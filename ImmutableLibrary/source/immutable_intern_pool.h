@@ -0,0 +1,84 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	template<class T, class Hash> ImmutableInternPool<T, Hash>::ImmutableInternPool()
+	{
+	};
+
+	template<class T, class Hash> ImmutableInternPool<T, Hash>::~ImmutableInternPool()
+	{
+		ImmutableBatch batch;
+		for (auto& shard : Shards)
+			for (auto& entry : shard.Entries)
+			{
+				auto target = const_cast<Entry*>(entry.second);
+				ImmutableAllocator<Entry>::destroy(target);
+				ImmutableAllocator<Entry>::deallocate(target, 1);
+			}
+	};
+
+	template<class T, class Hash> template<class Key> Interned<T> ImmutableInternPool<T, Hash>::Intern(const Key& key)
+	{
+		auto hashCode = Hash()(key);
+		auto& shard = Shards[hashCode % ShardCount];
+		{
+			const shared_lock<shared_mutex> guard(shard.Mutex);
+			auto entry = FindEntry(shard, hashCode, key);
+			if (entry != nullptr)
+				return Interned<T>(entry);
+		}
+
+		// the value is made outside of the allocator, since making it may allocate immutable memory as well
+		T value(key);
+		const unique_lock<shared_mutex> guard(shard.Mutex);
+		// another thread may have interned an equal value while the lock was released
+		auto entry = FindEntry(shard, hashCode, key);
+		if (entry != nullptr)
+			return Interned<T>(entry);
+
+		auto target = ImmutableAllocator<Entry>::allocate(1);
+		try
+		{
+			ImmutableAllocator<Entry>::construct(target, hashCode, move(value));
+		}
+		catch (...)
+		{
+			ImmutableAllocator<Entry>::deallocate(target, 1);
+			throw;
+		}
+		try
+		{
+			shard.Entries.emplace(hashCode, target);
+		}
+		catch (...)
+		{
+			ImmutableAllocator<Entry>::destroy(target);
+			ImmutableAllocator<Entry>::deallocate(target, 1);
+			throw;
+		}
+		return Interned<T>(target);
+	};
+
+	template<class T, class Hash> size_t ImmutableInternPool<T, Hash>::size() const
+	{
+		size_t result = 0;
+		for (auto& shard : Shards)
+		{
+			const shared_lock<shared_mutex> guard(shard.Mutex);
+			result += shard.Entries.size();
+		}
+		return result;
+	};
+
+	template<class T, class Hash> template<class Key> const typename ImmutableInternPool<T, Hash>::Entry* ImmutableInternPool<T, Hash>::FindEntry(const Shard& shard, size_t hashCode, const Key& key)
+	{
+		auto range = shard.Entries.equal_range(hashCode);
+		for (auto it = range.first; it != range.second; ++it)
+			if (it->second->Value == key)
+				return it->second;
+		return nullptr;
+	};
+};
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	inline ImmutableMemoryResource::ImmutableMemoryResource(size_t initialSize)
+	{
+		Cursor = nullptr;
+		End = nullptr;
+		NextRunSize = max(initialSize, ImmutableGlobalPageSource::GetPageSize());
+		Sealed = false;
+	};
+
+	inline ImmutableMemoryResource::~ImmutableMemoryResource()
+	{
+		for (auto page : Pages)
+		{
+			MemoryProtector::FreePage(page);
+			ImmutableGlobalPageSource::GetArena().FreeRun(page->StartAddress, page->TotalSize);
+			delete page;
+		}
+	};
+
+	inline void ImmutableMemoryResource::Seal()
+	{
+		if (Sealed)
+			return;
+		// runs grow twice each time, so even a large structure is sealed with a few calls
+		for (auto page : Pages)
+			MemoryProtector::LockPage(page);
+		Sealed = true;
+	};
+
+	inline bool ImmutableMemoryResource::IsSealed() const
+	{
+		return Sealed;
+	};
+
+	inline void* ImmutableMemoryResource::do_allocate(size_t bytes, size_t alignment)
+	{
+		constexpr auto resourceSealed = "Memory resource is sealed.";
+		constexpr auto arenaExhausted = "Memory arena is exhausted.";
+		if (Sealed)
+			throw runtime_error(resourceSealed);
+
+		auto aligned = (char*)(((uintptr_t)Cursor + alignment - 1) & ~(uintptr_t)(alignment - 1));
+		if (Cursor == nullptr || bytes > (size_t)(End - aligned) || aligned > End)
+		{
+			// runs start at a page, so only alignments larger than the page need room for padding
+			auto pageSize = ImmutableGlobalPageSource::GetPageSize();
+			auto requiredSize = bytes + ((alignment > pageSize) ? alignment : 0);
+			auto runSize = max(NextRunSize, requiredSize);
+			runSize = ((runSize + pageSize - 1) / pageSize) * pageSize;
+			auto& arena = ImmutableGlobalPageSource::GetArena();
+			auto runAddress = (char*)arena.CatchRun(runSize);
+			if (runAddress == nullptr)
+				throw runtime_error(arenaExhausted);
+			MemoryPage* page = nullptr;
+			try
+			{
+				page = MemoryProtector::CatchPage(runAddress, runSize);
+				MemoryProtector::UnlockPage(page);
+			}
+			catch (...)
+			{
+				if (page != nullptr)
+				{
+					MemoryProtector::FreePage(page);
+					delete page;
+				}
+				arena.FreeRun(runAddress, runSize);
+				throw;
+			}
+			Pages.push_back(page);
+			Cursor = runAddress;
+			End = runAddress + runSize;
+			NextRunSize = runSize * 2;
+			aligned = (char*)(((uintptr_t)Cursor + alignment - 1) & ~(uintptr_t)(alignment - 1));
+		}
+
+		Cursor = aligned + bytes;
+		return aligned;
+	};
+
+	inline void ImmutableMemoryResource::do_deallocate(void*, size_t, size_t)
+	{
+	};
+
+	inline bool ImmutableMemoryResource::do_is_equal(const pmr::memory_resource& other) const noexcept
+	{
+		return this == &other;
+	};
+};
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	inline MemoryArena& ImmutableGlobalPageSource::GetArena()
+	{
+		return ImmutableData::Arena;
+	};
+
+	inline MemoryHeap* ImmutableGlobalPageSource::GetThreadHeap()
+	{
+		return ImmutableData::ThreadHeap.Heap;
+	};
+
+	inline size_t ImmutableGlobalPageSource::GetPageSize()
+	{
+		return ImmutableData::PageSize;
+	};
+
+	template<class Tag, class Protector, size_t RegionSize> MemoryArena& ImmutableIsolatedPageSource<Tag, Protector, RegionSize>::GetArena()
+	{
+		static_assert(!Protector::HasWritableAlias, "A protector with a writable alias maps only the global region.");
+		// made on first use, so that the page size is already known
+		static MemoryArena arena(Protector::ReserveRegion(RegionSize, GetPageSize()), RegionSize, GetPageSize());
+		return arena;
+	};
+
+	template<class Tag, class Protector, size_t RegionSize> MemoryHeap* ImmutableIsolatedPageSource<Tag, Protector, RegionSize>::GetThreadHeap()
+	{
+		// heaps hold the pages of this region, so they are reused only by the threads of this source
+		static MemoryHeapPool pool;
+		static thread_local MemoryHeapLease lease(pool);
+		return lease.Heap;
+	};
+
+	template<class Tag, class Protector, size_t RegionSize> size_t ImmutableIsolatedPageSource<Tag, Protector, RegionSize>::GetPageSize()
+	{
+		static size_t pageSize = Protector::GetMemoryPageSize();
+		return pageSize;
+	};
+};
\ No newline at end of file
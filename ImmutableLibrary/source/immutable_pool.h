@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	inline void ImmutablePool::Reserve(size_t bytes)
+	{
+		constexpr auto arenaExhausted = "Memory arena is exhausted.";
+		auto pageSize = ImmutableData::PageSize;
+		auto regionSize = ((bytes + pageSize - 1) / pageSize) * pageSize;
+		auto heap = ImmutableData::ThreadHeap.Heap;
+		const MemoryHeapLock guard(heap);
+		// the reservation is cut down to the pages the heap may still keep under the limit
+		auto retainedSizeLimit = ImmutableData::RetainedSizeLimit.load(memory_order_relaxed);
+		auto freeRetainedSize = retainedSizeLimit > heap->RetainedSize ? retainedSizeLimit - heap->RetainedSize : 0;
+		regionSize = min(regionSize, (freeRetainedSize / pageSize) * pageSize);
+		if (regionSize == 0)
+			return;
+		// the whole run is taken from the system at once and only then divided into pages
+		auto regionAddress = (char*)ImmutableData::Arena.CatchRun(regionSize);
+		if (regionAddress == nullptr)
+			throw runtime_error(arenaExhausted);
+		try
+		{
+			MemoryProtector::PopulateRegion(regionAddress, regionSize);
+		}
+		catch (...)
+		{
+			ImmutableData::Arena.FreeRun(regionAddress, regionSize);
+			throw;
+		}
+		heap->Statistics.MapCalls.Add(1);
+		for (size_t offset = 0; offset < regionSize; offset += pageSize)
+		{
+			auto page = new MemoryPage(regionAddress + offset, pageSize);
+			page->OwnerHeap = heap;
+			heap->RetainedPages[pageSize].push_back(page);
+			heap->RetainedSize += pageSize;
+			heap->Statistics.LivePages.Add(1);
+			heap->Statistics.RetainedPages.Add(1);
+			ImmutableAllocator<char>::RaiseEvent(ImmutableEvent::PageCaught, page);
+		}
+	};
+
+	inline void ImmutablePool::Trim()
+	{
+		auto heap = ImmutableData::ThreadHeap.Heap;
+		const MemoryHeapLock guard(heap);
+		for (auto& retainedPages : heap->RetainedPages)
+			for (auto page : retainedPages.second)
+				MemoryProtector::DiscardPage(page);
+	};
+
+	inline void ImmutablePool::SetRetainedSizeLimit(size_t bytes)
+	{
+		ImmutableData::RetainedSizeLimit.store(bytes, memory_order_relaxed);
+	};
+};
\ No newline at end of file
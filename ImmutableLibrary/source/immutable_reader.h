@@ -0,0 +1,16 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	inline ImmutableReader::ImmutableReader()
+	{
+		ImmutableData::Epochs.Enter(ImmutableData::ThreadHeap.Heap);
+	};
+
+	inline ImmutableReader::~ImmutableReader()
+	{
+		ImmutableData::Epochs.Leave(ImmutableData::ThreadHeap.Heap);
+	};
+};
\ No newline at end of file
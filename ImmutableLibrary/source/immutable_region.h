@@ -0,0 +1,246 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	inline ImmutableRegion::ImmutableRegion(size_t initialSize)
+	{
+		OpenDepth = 0;
+		OpenBatch = nullptr;
+		FirstOpenPage = 0;
+		Cursor = nullptr;
+		End = nullptr;
+		NextRunSize = max(initialSize, ImmutableGlobalPageSource::GetPageSize());
+		UsedSize = 0;
+	};
+
+	inline ImmutableRegion::~ImmutableRegion()
+	{
+		Release();
+	};
+
+	template<class T, class... Args> T* ImmutableRegion::Create(Args&&... args)
+	{
+		static_assert(is_constructible_v<T, Args...>, "The required constructor was not found.");
+		constexpr auto wrongAlignment = "Alignment is not a power of two or is larger than the page.";
+		if (alignof(T) > ImmutableGlobalPageSource::GetPageSize())
+			throw runtime_error(wrongAlignment);
+		auto object = (T*)TakeMemory(sizeof(T), alignof(T));
+		// a plain object is built aside and copied through the writable alias, so its pages are never opened
+		if constexpr (MemoryProtector::HasWritableAlias && is_trivially_copyable_v<T>)
+		{
+			auto value = T(forward<Args>(args)...);
+			memcpy(MemoryProtector::GetWritableAddress(object), &value, sizeof(T));
+		}
+		else
+		{
+			OpenSpan(object, sizeof(T));
+			try
+			{
+				new(object) T(forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				CloseSpans();
+				throw;
+			}
+			CloseSpans();
+		}
+		if constexpr (!is_trivially_destructible_v<T>)
+			Finalizers.push_back({ object, 1, DestroyObjects<T> });
+		return object;
+	};
+
+	template<class T, class... Args> T* ImmutableRegion::CreateArray(size_t count, Args&&... args)
+	{
+		static_assert(is_constructible_v<T, Args...>, "The required constructor was not found.");
+		constexpr auto wrongAlignment = "Alignment is not a power of two or is larger than the page.";
+		if (alignof(T) > ImmutableGlobalPageSource::GetPageSize())
+			throw runtime_error(wrongAlignment);
+		if (count == 0)
+			return nullptr;
+		auto objects = (T*)TakeMemory(sizeof(T) * count, alignof(T));
+		OpenSpan(objects, sizeof(T) * count);
+		size_t constructedCount = 0;
+		try
+		{
+			for (; constructedCount < count; ++constructedCount)
+				new(objects + constructedCount) T(args...);
+		}
+		catch (...)
+		{
+			DestroyObjects<T>(objects, constructedCount);
+			CloseSpans();
+			throw;
+		}
+		CloseSpans();
+		if constexpr (!is_trivially_destructible_v<T>)
+			Finalizers.push_back({ objects, count, DestroyObjects<T> });
+		return objects;
+	};
+
+	inline void ImmutableRegion::Release()
+	{
+		if (OpenBatch != nullptr)
+		{
+			OpenBatch->OpenedRegions.erase(this);
+			OpenBatch = nullptr;
+		}
+		// destructors may write to their objects, so the pages are opened as a whole, and only if there are any
+		if (!Finalizers.empty())
+		{
+			for (auto page : Pages)
+				MemoryProtector::UnlockPage(page);
+			CountCalls(&HeapStatistics::RegionUnprotectCalls, Pages.size());
+			for (auto finalizer = Finalizers.rbegin(); finalizer != Finalizers.rend(); ++finalizer)
+				finalizer->Destroy(finalizer->Address, finalizer->Count);
+			Finalizers.clear();
+		}
+		// runs mostly extend each other, so there are only a few pages to return whatever the count of objects
+		for (auto page : Pages)
+		{
+			MemoryProtector::FreePage(page);
+			ImmutableGlobalPageSource::GetArena().FreeRun(page->StartAddress, page->TotalSize);
+			delete page;
+		}
+		CountCalls(&HeapStatistics::RegionUnmapCalls, Pages.size());
+		Pages.clear();
+		Cursor = nullptr;
+		End = nullptr;
+		UsedSize = 0;
+	};
+
+	inline size_t ImmutableRegion::size() const
+	{
+		return UsedSize;
+	};
+
+	inline void* ImmutableRegion::TakeMemory(size_t size, size_t alignment)
+	{
+		constexpr auto arenaExhausted = "Memory arena is exhausted.";
+		auto aligned = (char*)(((uintptr_t)Cursor + alignment - 1) & ~(uintptr_t)(alignment - 1));
+		if (Cursor == nullptr || aligned > End || size > (size_t)(End - aligned))
+		{
+			auto pageSize = ImmutableGlobalPageSource::GetPageSize();
+			auto runSize = max(NextRunSize, size + alignment);
+			runSize = ((runSize + pageSize - 1) / pageSize) * pageSize;
+			auto& arena = ImmutableGlobalPageSource::GetArena();
+			// a run right after the current one extends its page, so the region stays a single page as long as it can
+			if (!Pages.empty() && arena.CatchRunAt(End, runSize))
+			{
+				try
+				{
+					MemoryProtector::ExtendPage(Pages.back(), Pages.back()->TotalSize + runSize);
+				}
+				catch (...)
+				{
+					arena.FreeRun(End, runSize);
+					throw;
+				}
+				CountCalls(&HeapStatistics::RegionMapCalls);
+				// the added tail is sealed like any new memory, while the rest of the page is kept open by the batch
+				if (OpenBatch != nullptr)
+				{
+					MemoryPage tail(End, runSize);
+					MemoryProtector::UnlockPage(&tail);
+					CountCalls(&HeapStatistics::RegionUnprotectCalls);
+				}
+				End += runSize;
+			}
+			else
+			{
+				auto runAddress = (char*)arena.CatchRun(runSize);
+				if (runAddress == nullptr)
+					throw runtime_error(arenaExhausted);
+				try
+				{
+					Pages.push_back(MemoryProtector::CatchPage(runAddress, runSize));
+				}
+				catch (...)
+				{
+					arena.FreeRun(runAddress, runSize);
+					throw;
+				}
+				CountCalls(&HeapStatistics::RegionMapCalls);
+				if (OpenBatch != nullptr)
+				{
+					MemoryProtector::UnlockPage(Pages.back());
+					CountCalls(&HeapStatistics::RegionUnprotectCalls);
+				}
+				Cursor = runAddress;
+				End = runAddress + runSize;
+			}
+			NextRunSize = runSize * 2;
+			aligned = (char*)(((uintptr_t)Cursor + alignment - 1) & ~(uintptr_t)(alignment - 1));
+		}
+
+		Cursor = aligned + size;
+		UsedSize += size;
+		return aligned;
+	};
+
+	inline void ImmutableRegion::OpenSpan(void* address, size_t size)
+	{
+		if (!KeepOpenInBatch())
+		{
+			auto pageSize = (uintptr_t)ImmutableGlobalPageSource::GetPageSize();
+			auto first = (uintptr_t)address & ~(pageSize - 1);
+			auto last = ((uintptr_t)address + size + pageSize - 1) & ~(pageSize - 1);
+			MemoryPage span((void*)first, (size_t)(last - first));
+			MemoryProtector::UnlockPage(&span);
+			CountCalls(&HeapStatistics::RegionUnprotectCalls);
+			OpenSpans.emplace_back(span.StartAddress, span.TotalSize);
+		}
+		++OpenDepth;
+	};
+
+	inline void ImmutableRegion::CloseSpans()
+	{
+		if (--OpenDepth != 0)
+			return;
+		for (auto& [address, size] : OpenSpans)
+		{
+			MemoryPage span(address, size);
+			MemoryProtector::LockPage(&span);
+		}
+		CountCalls(&HeapStatistics::RegionProtectCalls, OpenSpans.size());
+		OpenSpans.clear();
+	};
+
+	inline bool ImmutableRegion::KeepOpenInBatch()
+	{
+		if (OpenBatch != nullptr)
+			return true;
+		// the page is opened as a whole only between constructions, so that no span opened before is left inside it
+		auto batch = ImmutableData::ThreadBatch;
+		if (batch == nullptr || OpenDepth != 0)
+			return false;
+		MemoryProtector::UnlockPage(Pages.back());
+		CountCalls(&HeapStatistics::RegionUnprotectCalls);
+		FirstOpenPage = Pages.size() - 1;
+		OpenBatch = batch;
+		batch->OpenedRegions.insert(this);
+		return true;
+	};
+
+	inline void ImmutableRegion::SealBatchPages()
+	{
+		for (auto i = FirstOpenPage; i < Pages.size(); ++i)
+			MemoryProtector::LockPage(Pages[i]);
+		CountCalls(&HeapStatistics::RegionProtectCalls, Pages.size() - FirstOpenPage);
+		OpenBatch = nullptr;
+	};
+
+	inline void ImmutableRegion::CountCalls(HeapCounter HeapStatistics::* counter, size_t count)
+	{
+		// the counters of regions are changed by the thread owning the heap alone, so no lock is taken on the way of every construction
+		(ImmutableGlobalPageSource::GetThreadHeap()->Statistics.*counter).Add(count);
+	};
+
+	template<class T> void ImmutableRegion::DestroyObjects(void* address, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+			((T*)address)[i].~T();
+	};
+};
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	template<class T> ImmutableSharedPtr<T>::ImmutableSharedPtr() : ImmutableSharedPtr(nullptr, nullptr)
+	{
+	};
+
+	template<class T> ImmutableSharedPtr<T>::ImmutableSharedPtr(T* object, atomic<size_t>* references)
+	{
+		Object = object;
+		References = references;
+	};
+
+	template<class T> ImmutableSharedPtr<T>::ImmutableSharedPtr(const ImmutableSharedPtr& other) : ImmutableSharedPtr(other.Object, other.References)
+	{
+		if (References != nullptr)
+			References->fetch_add(1, memory_order_relaxed);
+	};
+
+	template<class T> ImmutableSharedPtr<T>::ImmutableSharedPtr(ImmutableSharedPtr&& other) noexcept : ImmutableSharedPtr(other.Object, other.References)
+	{
+		other.Object = nullptr;
+		other.References = nullptr;
+	};
+
+	template<class T> ImmutableSharedPtr<T>& ImmutableSharedPtr<T>::operator=(ImmutableSharedPtr other) noexcept
+	{
+		swap(Object, other.Object);
+		swap(References, other.References);
+		return *this;
+	};
+
+	template<class T> ImmutableSharedPtr<T>::~ImmutableSharedPtr()
+	{
+		if (References == nullptr || References->fetch_sub(1, memory_order_acq_rel) != 1)
+			return;
+		ImmutableAllocator<T>::ReleaseReferenceCount(Object);
+		ImmutableAllocator<T>::destroy(Object);
+		ImmutableAllocator<T>::deallocate(Object, 1);
+	};
+
+	template<class T> const T* ImmutableSharedPtr<T>::get() const
+	{
+		return Object;
+	};
+
+	template<class T> const T& ImmutableSharedPtr<T>::operator*() const
+	{
+		return *Object;
+	};
+
+	template<class T> const T* ImmutableSharedPtr<T>::operator->() const
+	{
+		return Object;
+	};
+
+	template<class T> size_t ImmutableSharedPtr<T>::use_count() const
+	{
+		return (References == nullptr) ? 0 : References->load(memory_order_relaxed);
+	};
+
+	template<class T> ImmutableSharedPtr<T>::operator bool() const
+	{
+		return Object != nullptr;
+	};
+
+	template<class T, class... Args> ImmutableSharedPtr<T> MakeImmutableShared(Args&&... args)
+	{
+		auto object = ImmutableAllocator<T>::allocate(1);
+		try
+		{
+			ImmutableAllocator<T>::construct(object, forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			ImmutableAllocator<T>::deallocate(object, 1);
+			throw;
+		}
+		try
+		{
+			return ImmutableSharedPtr<T>(object, ImmutableAllocator<T>::CreateReferenceCount(object));
+		}
+		catch (...)
+		{
+			ImmutableAllocator<T>::destroy(object);
+			ImmutableAllocator<T>::deallocate(object, 1);
+			throw;
+		}
+	};
+};
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	inline ImmutableSnapshot::ImmutableSnapshot(const string& path)
+	{
+		StartAddress = (const char*)MemoryProtector::MapFile(path, TotalSize);
+		CheckHeader();
+	};
+
+#ifdef __linux__
+	inline ImmutableSnapshot::ImmutableSnapshot(int sharedMemory)
+	{
+		StartAddress = (const char*)MemoryProtector::MapSealedMemory(sharedMemory, TotalSize);
+		CheckHeader();
+	};
+#endif
+
+	inline void ImmutableSnapshot::CheckHeader()
+	{
+		constexpr auto corruptedSnapshot = "Snapshot file is corrupted.";
+		// the header is checked before any view is handed out so that offsets can be trusted
+		auto header = (const Header*)StartAddress;
+		auto isValid = TotalSize >= sizeof(Header)
+			&& header->Signature == FormatSignature
+			&& header->Version == FormatVersion
+			&& header->TotalSize == TotalSize
+			&& (header->RootOffset == 0 || (header->RootOffset >= sizeof(Header) && header->RootOffset < TotalSize));
+		if (isValid)
+			return;
+		MemoryProtector::UnmapFile((void*)StartAddress, TotalSize);
+		throw runtime_error(corruptedSnapshot);
+	};
+
+	inline ImmutableSnapshot::~ImmutableSnapshot()
+	{
+		MemoryProtector::UnmapFile((void*)StartAddress, TotalSize);
+	};
+
+	template<class T> const T* ImmutableSnapshot::Root() const
+	{
+		auto header = (const Header*)StartAddress;
+		return View<T>((size_t)header->RootOffset);
+	};
+
+	template<class T> const T* ImmutableSnapshot::View(size_t offset, size_t count_objects) const
+	{
+		static_assert(is_trivially_copyable_v<T>, "Only plain objects can be viewed in a snapshot.");
+		constexpr auto outOfSnapshot = "Snapshot offset is out of range.";
+		if (offset < sizeof(Header) || offset > TotalSize || (TotalSize - offset) / sizeof(T) < count_objects)
+			throw runtime_error(outOfSnapshot);
+		if (offset % alignof(T) != 0)
+			throw runtime_error(outOfSnapshot);
+		return (const T*)(StartAddress + offset);
+	};
+
+	inline size_t ImmutableSnapshot::size() const
+	{
+		return TotalSize;
+	};
+
+#ifdef __unix__
+	inline void ImmutableSnapshot::SendSharedMemory(int socket, int sharedMemory)
+	{
+		MemoryProtector::SendDescriptor(socket, sharedMemory);
+	};
+
+	inline int ImmutableSnapshot::ReceiveSharedMemory(int socket)
+	{
+		return MemoryProtector::ReceiveDescriptor(socket);
+	};
+#endif
+};
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	inline ImmutableSnapshotBuilder::ImmutableSnapshotBuilder()
+	{
+		Buffer.resize(sizeof(ImmutableSnapshot::Header));
+		RootOffset = 0;
+	};
+
+	template<class T> size_t ImmutableSnapshotBuilder::Append(const T* values, size_t count_objects)
+	{
+		static_assert(is_trivially_copyable_v<T>, "Only plain objects can be written to a snapshot.");
+		// the file is mapped at a page boundary, so alignment from the beginning of the file is kept in memory
+		auto offset = (Buffer.size() + alignof(T) - 1) / alignof(T) * alignof(T);
+		Buffer.resize(offset + sizeof(T) * count_objects);
+		if (count_objects != 0)
+			memcpy(Buffer.data() + offset, values, sizeof(T) * count_objects);
+		return offset;
+	};
+
+	template<class T> size_t ImmutableSnapshotBuilder::Append(const T& value)
+	{
+		return Append(&value, 1);
+	};
+
+	template<class T> void ImmutableSnapshotBuilder::Link(size_t pointerOffset, size_t targetOffset)
+	{
+		constexpr auto outOfSnapshot = "Snapshot offset is out of range.";
+		if (pointerOffset + sizeof(SnapshotPointer<T>) > Buffer.size() || targetOffset > Buffer.size())
+			throw runtime_error(outOfSnapshot);
+		SnapshotPointer<T> pointer;
+		pointer.Offset = (ptrdiff_t)targetOffset - (ptrdiff_t)pointerOffset;
+		memcpy(Buffer.data() + pointerOffset, &pointer, sizeof(pointer));
+	};
+
+	inline void ImmutableSnapshotBuilder::SetRoot(size_t rootOffset)
+	{
+		constexpr auto outOfSnapshot = "Snapshot offset is out of range.";
+		if (rootOffset < sizeof(ImmutableSnapshot::Header) || rootOffset >= Buffer.size())
+			throw runtime_error(outOfSnapshot);
+		RootOffset = rootOffset;
+	};
+
+	inline void ImmutableSnapshotBuilder::Save(const string& path) const
+	{
+		constexpr auto notWritten = "Snapshot file is not written.";
+		auto contents = Seal();
+		ofstream file(path, ios::binary | ios::trunc);
+		file.write(contents.data(), contents.size());
+		file.close();
+		if (!file)
+			throw runtime_error(notWritten);
+	};
+
+#ifdef __linux__
+	inline int ImmutableSnapshotBuilder::Share() const
+	{
+		auto contents = Seal();
+		return MemoryProtector::CreateSealedMemory(contents.data(), contents.size());
+	};
+#endif
+
+	inline vector<char> ImmutableSnapshotBuilder::Seal() const
+	{
+		ImmutableSnapshot::Header header;
+		header.Signature = ImmutableSnapshot::FormatSignature;
+		header.Version = ImmutableSnapshot::FormatVersion;
+		header.TotalSize = Buffer.size();
+		header.RootOffset = RootOffset;
+		auto contents = Buffer;
+		memcpy(contents.data(), &header, sizeof(header));
+		return contents;
+	};
+};
\ No newline at end of file
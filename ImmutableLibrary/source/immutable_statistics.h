@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	inline ImmutableStatistics ImmutableStatistics::Collect()
+	{
+		ImmutableStatistics result = {};
+		// counters are read without locking, so the sum is only as consistent as the heaps were at that moment
+		for (auto heap : MemoryHeap::GetAllHeaps())
+		{
+			auto& statistics = heap->Statistics;
+			result.LivePages += statistics.LivePages.Read();
+			result.LiveBlocks += statistics.LiveBlocks.Read();
+			result.LiveBytes += statistics.LiveBytes.Read();
+			result.RetainedPages += statistics.RetainedPages.Read();
+			result.WastedTailBytes += statistics.WastedTailBytes.Read();
+			result.ProtectCalls += statistics.ProtectCalls.Read() + statistics.RegionProtectCalls.Read();
+			result.UnprotectCalls += statistics.UnprotectCalls.Read() + statistics.RegionUnprotectCalls.Read();
+			result.MapCalls += statistics.MapCalls.Read() + statistics.RegionMapCalls.Read();
+			result.UnmapCalls += statistics.UnmapCalls.Read() + statistics.RegionUnmapCalls.Read();
+			result.LockAcquisitions += statistics.LockAcquisitions.Read();
+			result.ContendedLockAcquisitions += statistics.ContendedLockAcquisitions.Read();
+			result.LockWaitNanoseconds += statistics.LockWaitNanoseconds.Read();
+			result.LockHoldNanoseconds += statistics.LockHoldNanoseconds.Read();
+			for (size_t i = 0; i < HeapStatistics::HistogramSize; ++i)
+				result.AllocationSizeHistogram[i] += statistics.AllocationSizes[i].Read();
+		}
+		return result;
+	};
+
+	inline void ImmutableStatistics::EnableLockTiming(bool isEnabled)
+	{
+		HeapStatistics::IsLockTimingEnabled.store(isEnabled, memory_order_relaxed);
+	};
+
+	inline void ImmutableStatistics::SetEventHook(ImmutableEventHook hook)
+	{
+		ImmutableData::EventHook.store(hook, memory_order_release);
+	};
+};
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	inline void ImmutableTrace::Start(const string& path)
+	{
+		TraceRecorder::Start(path);
+	};
+
+	inline void ImmutableTrace::Stop()
+	{
+		TraceRecorder::Stop();
+	};
+
+	inline vector<TraceRecord> ImmutableTrace::Load(const string& path)
+	{
+		auto result = TraceRecorder::Load(path);
+		// threads write their buffers at different moments, so the file keeps the order of calls only within a thread
+		stable_sort(result.begin(), result.end(), [](const TraceRecord& left, const TraceRecord& right) { return left.Nanoseconds < right.Nanoseconds; });
+		return result;
+	};
+};
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "../../headers/internals/epoch_domain.h"
+
+namespace immutable::internals
+{
+	RetiredObject::RetiredObject
+	(
+		void* address,
+		size_t count,
+		void (*reclaim)(void*, size_t),
+		size_t epoch
+	)
+	{
+		Address = address;
+		Count = count;
+		Reclaim = reclaim;
+		Epoch = epoch;
+	};
+
+	EpochDomain::EpochDomain()
+	{
+		GlobalEpoch = 1;
+	};
+
+	void EpochDomain::Enter(MemoryHeap* heap)
+	{
+		if (heap->ReaderDepth++ != 0)
+			return;
+		heap->ReaderEpoch.store(GlobalEpoch.load(memory_order_relaxed), memory_order_relaxed);
+		// the mark must be visible before any shared object is read
+		atomic_thread_fence(memory_order_seq_cst);
+	};
+
+	void EpochDomain::Leave(MemoryHeap* heap)
+	{
+		if (--heap->ReaderDepth != 0)
+			return;
+		heap->ReaderEpoch.store(0, memory_order_release);
+	};
+
+	bool EpochDomain::Retire(void* address, size_t count, void (*reclaim)(void*, size_t))
+	{
+		const lock_guard<mutex> guard(Mutex);
+		RetiredObjects.emplace_back(address, count, reclaim, GlobalEpoch.load());
+		return RetiredObjects.size() >= CollectThreshold;
+	};
+
+	vector<RetiredObject> EpochDomain::TakeReclaimable()
+	{
+		auto epoch = TryAdvance();
+		vector<RetiredObject> result;
+		const lock_guard<mutex> guard(Mutex);
+		// objects of the epoch before the previous one cannot be seen by any reader left
+		auto it = partition(RetiredObjects.begin(), RetiredObjects.end(), [epoch](const RetiredObject& object) { return object.Epoch + 2 > epoch; });
+		result.assign(it, RetiredObjects.end());
+		RetiredObjects.erase(it, RetiredObjects.end());
+		return result;
+	};
+
+	size_t EpochDomain::TryAdvance()
+	{
+		auto epoch = GlobalEpoch.load(memory_order_relaxed);
+		atomic_thread_fence(memory_order_seq_cst);
+		for (auto heap : MemoryHeap::GetAllHeaps())
+		{
+			auto readerEpoch = heap->ReaderEpoch.load(memory_order_relaxed);
+			if (readerEpoch != 0 && readerEpoch != epoch)
+				return epoch;
+		}
+		atomic_thread_fence(memory_order_acquire);
+		// another thread may have advanced the epoch meanwhile, which is just as good
+		GlobalEpoch.compare_exchange_strong(epoch, epoch + 1, memory_order_release, memory_order_relaxed);
+		return GlobalEpoch.load(memory_order_relaxed);
+	};
+};
\ No newline at end of file
@@ -0,0 +1,30 @@
+#include "../../headers/internals/heap_statistics.h"
+
+namespace immutable::internals
+{
+	HeapCounter::HeapCounter()
+	{
+		Value = 0;
+	};
+
+	void HeapCounter::Add(size_t value)
+	{
+		Value.store(Value.load(memory_order_relaxed) + value, memory_order_relaxed);
+	};
+
+	void HeapCounter::Subtract(size_t value)
+	{
+		Value.store(Value.load(memory_order_relaxed) - value, memory_order_relaxed);
+	};
+
+	size_t HeapCounter::Read() const
+	{
+		return Value.load(memory_order_relaxed);
+	};
+
+	void HeapStatistics::CountAllocation(size_t allocationSize)
+	{
+		auto bucket = (size_t)bit_width(allocationSize);
+		AllocationSizes[(bucket < HistogramSize) ? bucket : (HistogramSize - 1)].Add(1);
+	};
+};
\ No newline at end of file
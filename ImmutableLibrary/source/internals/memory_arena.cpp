@@ -0,0 +1,129 @@
+#include "../../headers/internals/memory_arena.h"
+
+namespace immutable::internals
+{
+	MemoryArena::MemoryArena
+	(
+		void* startAddress,
+		size_t totalSize,
+		size_t pageSize
+	)
+	{
+		StartAddress = (char*)startAddress;
+		TotalSize = totalSize;
+		PageShift = 0;
+		while (((size_t)1 << PageShift) < pageSize)
+			++PageShift;
+		FillOffset = 0;
+		// zeroed memory is a table of null pointers, which the system commits only on first touch
+		PagesTable = (atomic<MemoryPage*>*)calloc(totalSize >> PageShift, sizeof(atomic<MemoryPage*>));
+		constexpr auto tableNotAllocated = "Memory arena table is not allocated.";
+		if (PagesTable == nullptr)
+			throw runtime_error(tableNotAllocated);
+	};
+
+	void* MemoryArena::CatchRun(size_t runSize)
+	{
+		const lock_guard<mutex> guard(Mutex);
+
+		for (auto it = FreeRuns.begin(); it != FreeRuns.end(); ++it)
+		{
+			if (it->second < runSize)
+				continue;
+			auto result = it->first;
+			it->first += runSize;
+			it->second -= runSize;
+			if (it->second == 0)
+				FreeRuns.erase(it);
+			return result;
+		}
+
+		if (TotalSize - FillOffset < runSize)
+			return nullptr;
+		auto result = StartAddress + FillOffset;
+		FillOffset += runSize;
+		return result;
+	};
+
+	bool MemoryArena::CatchRunAt(void* startAddress, size_t runSize)
+	{
+		const lock_guard<mutex> guard(Mutex);
+		auto address = (char*)startAddress;
+
+		for (auto it = FreeRuns.begin(); it != FreeRuns.end() && it->first <= address; ++it)
+		{
+			if (address + runSize > it->first + it->second)
+				continue;
+			// the run is cut out of the middle of a free one, leaving its head and its tail free
+			auto tailSize = (size_t)((it->first + it->second) - (address + runSize));
+			it->second = (size_t)(address - it->first);
+			if (tailSize != 0)
+				it = FreeRuns.insert(it + 1, { address + runSize, tailSize }) - 1;
+			if (it->second == 0)
+				FreeRuns.erase(it);
+			return true;
+		}
+
+		if (address != StartAddress + FillOffset || TotalSize - FillOffset < runSize)
+			return false;
+		FillOffset += runSize;
+		return true;
+	};
+
+	void MemoryArena::FreeRun(void* startAddress, size_t runSize)
+	{
+		const lock_guard<mutex> guard(Mutex);
+		auto address = (char*)startAddress;
+
+		auto next = FreeRuns.begin();
+		while (next != FreeRuns.end() && next->first < address)
+			++next;
+		next = FreeRuns.insert(next, { address, runSize });
+
+		// merge with the following run so that large runs can be caught again
+		auto following = next + 1;
+		if (following != FreeRuns.end() && next->first + next->second == following->first)
+		{
+			next->second += following->second;
+			FreeRuns.erase(following);
+		}
+
+		// merge with the preceding run for the same reason
+		if (next != FreeRuns.begin())
+		{
+			auto preceding = next - 1;
+			if (preceding->first + preceding->second == next->first)
+			{
+				preceding->second += next->second;
+				FreeRuns.erase(next);
+			}
+		}
+	};
+
+	void MemoryArena::BindPage(MemoryPage* page)
+	{
+		StorePage(page, page);
+	};
+
+	void MemoryArena::UnbindPage(MemoryPage* page)
+	{
+		StorePage(page, nullptr);
+	};
+
+	MemoryPage* MemoryArena::FindPage(void* address)
+	{
+		auto offset = (size_t)((char*)address - StartAddress);
+		// addresses below the region wrap around and fail the same bounds check
+		if (offset >= TotalSize)
+			return nullptr;
+		return PagesTable[offset >> PageShift].load(memory_order_acquire);
+	};
+
+	void MemoryArena::StorePage(MemoryPage* page, MemoryPage* value)
+	{
+		auto first = (size_t)((char*)page->StartAddress - StartAddress) >> PageShift;
+		auto count = page->TotalSize >> PageShift;
+		for (size_t i = 0; i < count; ++i)
+			PagesTable[first + i].store(value, memory_order_release);
+	};
+};
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "../../headers/internals/memory_heap.h"
+
+namespace immutable::internals
+{
+	RemoteRelease::RemoteRelease
+	(
+		void* startAddress,
+		size_t blockSize,
+		size_t blockCount
+	)
+	{
+		StartAddress = startAddress;
+		BlockSize = blockSize;
+		BlockCount = blockCount;
+		Next = nullptr;
+	};
+
+	MemoryHeap::MemoryHeap()
+	{
+		RemoteReleases = nullptr;
+		RetainedSize = 0;
+		ReaderEpoch = 0;
+		ReaderDepth = 0;
+		OwnerPool = nullptr;
+	};
+
+	void MemoryHeap::PushRemoteRelease(RemoteRelease* release)
+	{
+		release->Next = RemoteReleases.load(memory_order_relaxed);
+		while (!RemoteReleases.compare_exchange_weak(release->Next, release, memory_order_release, memory_order_relaxed));
+	};
+
+	RemoteRelease* MemoryHeap::TakeRemoteReleases()
+	{
+		if (RemoteReleases.load(memory_order_relaxed) == nullptr)
+			return nullptr;
+		return RemoteReleases.exchange(nullptr, memory_order_acquire);
+	};
+
+	MemoryHeap* MemoryHeap::Acquire(MemoryHeapPool& pool)
+	{
+		const lock_guard<mutex> guard(AbandonedMutex);
+		if (pool.AbandonedHeaps.empty())
+		{
+			auto heap = new MemoryHeap();
+			heap->OwnerPool = &pool;
+			AllHeaps.push_back(heap);
+			return heap;
+		}
+		auto heap = pool.AbandonedHeaps.front();
+		pool.AbandonedHeaps.pop_front();
+		return heap;
+	};
+
+	void MemoryHeap::Abandon(MemoryHeap* heap)
+	{
+		const lock_guard<mutex> guard(AbandonedMutex);
+		heap->OwnerPool->AbandonedHeaps.push_back(heap);
+	};
+
+	vector<MemoryHeap*> MemoryHeap::GetAllHeaps()
+	{
+		const lock_guard<mutex> guard(AbandonedMutex);
+		return vector<MemoryHeap*>(AllHeaps.begin(), AllHeaps.end());
+	};
+
+	MemoryHeapLock::MemoryHeapLock(MemoryHeap* heap)
+	{
+		Heap = heap;
+		IsTimed = HeapStatistics::IsLockTimingEnabled.load(memory_order_relaxed);
+		// the clock is read only if the lock is contended, so the usual path stays as cheap as a plain lock
+		if (!Heap->Mutex.try_lock())
+		{
+			auto waitStart = chrono::steady_clock::now();
+			Heap->Mutex.lock();
+			auto waitTime = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - waitStart);
+			Heap->Statistics.ContendedLockAcquisitions.Add(1);
+			Heap->Statistics.LockWaitNanoseconds.Add(waitTime.count());
+		}
+		Heap->Statistics.LockAcquisitions.Add(1);
+		if (IsTimed)
+			AcquiredTime = chrono::steady_clock::now();
+	};
+
+	MemoryHeapLock::~MemoryHeapLock()
+	{
+		if (IsTimed)
+		{
+			auto holdTime = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - AcquiredTime);
+			Heap->Statistics.LockHoldNanoseconds.Add(holdTime.count());
+		}
+		Heap->Mutex.unlock();
+	};
+
+	MemoryHeapLease::MemoryHeapLease(MemoryHeapPool& pool)
+	{
+		Heap = MemoryHeap::Acquire(pool);
+	};
+
+	MemoryHeapLease::~MemoryHeapLease()
+	{
+		MemoryHeap::Abandon(Heap);
+	};
+};
\ No newline at end of file
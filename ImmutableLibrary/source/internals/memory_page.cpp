@@ -1,4 +1,6 @@
-#include "..\..\headers\internals\memory_page.h"
+#include <bit>
+
+#include "../../headers/internals/memory_page.h"
 
 namespace immutable::internals
 {
@@ -10,7 +12,171 @@ namespace immutable::internals
 	{
 		StartAddress = startAddress;
 		TotalSize = totalSize;
-		FillOffset = 0;
+		SlotSize = 0;
+		SlotsCount = 0;
 		BlocksCount = 0;
+		UnlockCount = 0;
+		OwnerHeap = nullptr;
+		IsCached = false;
+		Checksum = 0;
+		Temperature = PageTemperature::Warm;
+		CompressedSize = 0;
+		Touch();
+	};
+
+	void MemoryPage::FormatSlots(size_t slotSize)
+	{
+		SlotSize = slotSize;
+		SlotsCount = TotalSize / slotSize;
+		FreeSlotsBitmap.assign((SlotsCount + 63) / 64, ~(uint64_t)0);
+		// bits past the last slot stay cleared so that they never look free
+		if (SlotsCount % 64 != 0)
+			FreeSlotsBitmap.back() = ((uint64_t)1 << (SlotsCount % 64)) - 1;
+		InitializedSlotsBitmap.assign(FreeSlotsBitmap.size(), 0);
+		// the counters follow the layout of the slots, so they are made anew once needed again
+		ReferenceCounts.clear();
+	};
+
+	void MemoryPage::ExtendSlots()
+	{
+		auto oldSlotsCount = SlotsCount;
+		SlotsCount = TotalSize / SlotSize;
+		// bits past the old last slot are cleared, so the new slots are just marked free
+		FreeSlotsBitmap.resize((SlotsCount + 63) / 64, 0);
+		InitializedSlotsBitmap.resize(FreeSlotsBitmap.size(), 0);
+		ReleaseSlots(oldSlotsCount, SlotsCount - oldSlotsCount);
+	};
+
+	void MemoryPage::Touch()
+	{
+		LastTouchTime.store(chrono::steady_clock::now().time_since_epoch().count(), memory_order_relaxed);
+	};
+
+	atomic<size_t>* MemoryPage::CreateReferenceCount(size_t slot)
+	{
+		// counters are made for groups of neighbouring slots, so that many shared objects cost a single allocation while pages sharing a few objects stay small
+		if (ReferenceCounts.empty())
+			ReferenceCounts.resize((SlotsCount + ReferenceCountGroup::Size - 1) / ReferenceCountGroup::Size);
+		auto& group = ReferenceCounts[slot / ReferenceCountGroup::Size];
+		if (group == nullptr)
+			group = make_unique<ReferenceCountGroup>();
+		++group->UsedCount;
+		auto& references = group->Counts[slot % ReferenceCountGroup::Size];
+		references.store(1, memory_order_relaxed);
+		return &references;
+	};
+
+	void MemoryPage::ReleaseReferenceCount(size_t slot)
+	{
+		auto& group = ReferenceCounts[slot / ReferenceCountGroup::Size];
+		if (--group->UsedCount != 0)
+			return;
+		group.reset();
+		// a page without counters can grow in place again
+		for (auto& other : ReferenceCounts)
+			if (other != nullptr)
+				return;
+		ReferenceCounts.clear();
+	};
+
+	size_t MemoryPage::FindFreeSlots(size_t slotCount, size_t slotStep)
+	{
+		// aligned sequences are rare, so their possible starts are simply checked one by one
+		if (slotStep != 1)
+		{
+			for (size_t firstSlot = 0; firstSlot + slotCount <= SlotsCount; firstSlot += slotStep)
+				if (AreSlotsFree(firstSlot, slotCount))
+					return firstSlot;
+			return SlotsCount;
+		}
+
+		size_t runStart = 0;
+		size_t runLength = 0;
+
+		for (size_t word = 0; word < FreeSlotsBitmap.size(); ++word)
+		{
+			auto bits = FreeSlotsBitmap[word];
+			// the most common request for a single slot is just the lowest set bit
+			if (slotCount == 1 && bits != 0)
+				return word * 64 + countr_zero(bits);
+			// whole words are skipped or counted at once, only mixed ones are walked bit by bit
+			if (bits == 0)
+			{
+				runLength = 0;
+				continue;
+			}
+			if (bits == ~(uint64_t)0)
+			{
+				if (runLength == 0)
+					runStart = word * 64;
+				runLength += 64;
+				if (runLength >= slotCount)
+					return runStart;
+				continue;
+			}
+			for (size_t bit = 0; bit < 64; ++bit)
+			{
+				if ((bits & ((uint64_t)1 << bit)) == 0)
+				{
+					runLength = 0;
+					continue;
+				}
+				if (runLength++ == 0)
+					runStart = word * 64 + bit;
+				if (runLength == slotCount)
+					return runStart;
+			}
+		}
+
+		return SlotsCount;
+	};
+
+	void MemoryPage::CatchSlots(size_t firstSlot, size_t slotCount)
+	{
+		for (auto slot = firstSlot; slot < firstSlot + slotCount; ++slot)
+			FreeSlotsBitmap[slot / 64] &= ~((uint64_t)1 << (slot % 64));
+	};
+
+	void MemoryPage::ReleaseSlots(size_t firstSlot, size_t slotCount)
+	{
+		for (auto slot = firstSlot; slot < firstSlot + slotCount; ++slot)
+			FreeSlotsBitmap[slot / 64] |= ((uint64_t)1 << (slot % 64));
+	};
+
+	bool MemoryPage::AreSlotsFree(size_t firstSlot, size_t slotCount)
+	{
+		for (auto slot = firstSlot; slot < firstSlot + slotCount; ++slot)
+			if ((FreeSlotsBitmap[slot / 64] & ((uint64_t)1 << (slot % 64))) == 0)
+				return false;
+		return true;
+	};
+
+	bool MemoryPage::AreSlotsCatched(size_t firstSlot, size_t slotCount)
+	{
+		for (auto slot = firstSlot; slot < firstSlot + slotCount; ++slot)
+			if ((FreeSlotsBitmap[slot / 64] & ((uint64_t)1 << (slot % 64))) != 0)
+				return false;
+		return true;
+	};
+
+	bool MemoryPage::IsSlotInitialized(size_t slot)
+	{
+		return (InitializedSlotsBitmap[slot / 64] & ((uint64_t)1 << (slot % 64))) != 0;
+	};
+
+	bool MemoryPage::IsAnySlotInitialized(size_t firstSlot, size_t slotCount)
+	{
+		for (auto slot = firstSlot; slot < firstSlot + slotCount; ++slot)
+			if (IsSlotInitialized(slot))
+				return true;
+		return false;
+	};
+
+	void MemoryPage::SetSlotInitialized(size_t slot, bool isInitialized)
+	{
+		if (isInitialized)
+			InitializedSlotsBitmap[slot / 64] |= ((uint64_t)1 << (slot % 64));
+		else
+			InitializedSlotsBitmap[slot / 64] &= ~((uint64_t)1 << (slot % 64));
 	};
 };
\ No newline at end of file
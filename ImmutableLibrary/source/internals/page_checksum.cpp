@@ -0,0 +1,110 @@
+#include <array>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define IMMUTABLE_CRC32C_INSTRUCTION __attribute__((target("sse4.2")))
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define IMMUTABLE_CRC32C_INSTRUCTION
+#endif
+
+#include "../../headers/internals/page_checksum.h"
+
+namespace immutable::internals
+{
+	// Reversed Castagnoli polynomial.
+	constexpr uint32_t Polynomial = 0x82F63B78;
+
+	// Tables for eight bytes at a time: the first one is the usual bytewise table, each next one moves a byte further.
+	constexpr auto MakeTables()
+	{
+		array<array<uint32_t, 256>, 8> tables{};
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			auto crc = i;
+			for (int bit = 0; bit < 8; ++bit)
+				crc = (crc >> 1) ^ ((crc & 1) != 0 ? Polynomial : 0);
+			tables[0][i] = crc;
+		}
+		for (size_t table = 1; table < 8; ++table)
+			for (size_t i = 0; i < 256; ++i)
+				tables[table][i] = (tables[table - 1][i] >> 8) ^ tables[0][tables[table - 1][i] & 0xFF];
+		return tables;
+	};
+
+	constexpr auto Tables = MakeTables();
+
+	uint32_t PageChecksum::Compute(const void* startAddress, size_t size)
+	{
+		auto bytes = (const uint8_t*)startAddress;
+		if (HasInstruction())
+			return ComputeWithInstruction(bytes, size);
+		return ComputeWithTables(bytes, size);
+	};
+
+#ifdef IMMUTABLE_CRC32C_INSTRUCTION
+	IMMUTABLE_CRC32C_INSTRUCTION uint32_t PageChecksum::ComputeWithInstruction(const uint8_t* bytes, size_t size)
+	{
+		uint64_t crc = ~(uint32_t)0;
+		for (; size >= 8; bytes += 8, size -= 8)
+		{
+			uint64_t word;
+			memcpy(&word, bytes, 8);
+#ifdef __aarch64__
+			crc = __crc32cd((uint32_t)crc, word);
+#elif defined(__x86_64__)
+			crc = _mm_crc32_u64(crc, word);
+#else
+			crc = _mm_crc32_u32(_mm_crc32_u32((uint32_t)crc, (uint32_t)word), (uint32_t)(word >> 32));
+#endif
+		}
+		for (; size != 0; ++bytes, --size)
+		{
+#ifdef __aarch64__
+			crc = __crc32cb((uint32_t)crc, *bytes);
+#else
+			crc = _mm_crc32_u8((uint32_t)crc, *bytes);
+#endif
+		}
+		return ~(uint32_t)crc;
+	};
+
+	bool PageChecksum::HasInstruction()
+	{
+#ifdef __aarch64__
+		return true;
+#else
+		static const bool hasInstruction = __builtin_cpu_supports("sse4.2");
+		return hasInstruction;
+#endif
+	};
+#else
+	uint32_t PageChecksum::ComputeWithInstruction(const uint8_t* bytes, size_t size)
+	{
+		return ComputeWithTables(bytes, size);
+	};
+
+	bool PageChecksum::HasInstruction()
+	{
+		return false;
+	};
+#endif
+
+	uint32_t PageChecksum::ComputeWithTables(const uint8_t* bytes, size_t size)
+	{
+		auto crc = ~(uint32_t)0;
+		for (; size >= 8; bytes += 8, size -= 8)
+		{
+			uint32_t low, high;
+			memcpy(&low, bytes, 4);
+			memcpy(&high, bytes + 4, 4);
+			// the tables are made for the little-endian order of bytes in the words
+			low ^= crc;
+			crc = Tables[7][low & 0xFF] ^ Tables[6][(low >> 8) & 0xFF] ^ Tables[5][(low >> 16) & 0xFF] ^ Tables[4][low >> 24]
+				^ Tables[3][high & 0xFF] ^ Tables[2][(high >> 8) & 0xFF] ^ Tables[1][(high >> 16) & 0xFF] ^ Tables[0][high >> 24];
+		}
+		for (; size != 0; ++bytes, --size)
+			crc = (crc >> 8) ^ Tables[0][(crc ^ *bytes) & 0xFF];
+		return ~crc;
+	};
+};
\ No newline at end of file
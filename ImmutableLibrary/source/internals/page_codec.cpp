@@ -0,0 +1,116 @@
+#include <algorithm>
+
+#include "../../headers/internals/page_codec.h"
+
+namespace immutable::internals
+{
+	size_t PageCodec::GetCompressedBound(size_t size)
+	{
+		return size + size / 255 + 16;
+	};
+
+	size_t PageCodec::Compress(const void* startAddress, size_t size, uint8_t* target)
+	{
+		auto source = (const uint8_t*)startAddress;
+		auto end = source + size;
+		auto position = source;
+		auto anchor = source;
+		auto output = target;
+		// positions are kept plus one, so that zero means no earlier occurrence
+		uint32_t table[(size_t)1 << HashBits] = {};
+
+		while (position + MinMatch <= end)
+		{
+			uint32_t sequence;
+			memcpy(&sequence, position, MinMatch);
+			auto hash = (sequence * 2654435761u) >> (32 - HashBits);
+			auto candidate = table[hash];
+			table[hash] = (uint32_t)(position - source) + 1;
+			if (candidate == 0 || (size_t)(position - source) - (candidate - 1) > MaxOffset || memcmp(source + candidate - 1, position, MinMatch) != 0)
+			{
+				++position;
+				continue;
+			}
+
+			auto match = source + candidate - 1;
+			auto matchLength = MinMatch;
+			while (position + matchLength < end && match[matchLength] == position[matchLength])
+				++matchLength;
+
+			auto literalLength = (size_t)(position - anchor);
+			auto token = output++;
+			*token = (uint8_t)((min<size_t>(literalLength, 15) << 4) | min<size_t>(matchLength - MinMatch, 15));
+			if (literalLength >= 15)
+				output = WriteLength(output, literalLength - 15);
+			memcpy(output, anchor, literalLength);
+			output += literalLength;
+			auto offset = (size_t)(position - match);
+			*output++ = (uint8_t)(offset & 0xFF);
+			*output++ = (uint8_t)(offset >> 8);
+			if (matchLength - MinMatch >= 15)
+				output = WriteLength(output, matchLength - MinMatch - 15);
+			position += matchLength;
+			anchor = position;
+		}
+
+		// the last run of literals has no copy after it, which the end of the input tells
+		auto literalLength = (size_t)(end - anchor);
+		*output++ = (uint8_t)(min<size_t>(literalLength, 15) << 4);
+		if (literalLength >= 15)
+			output = WriteLength(output, literalLength - 15);
+		memcpy(output, anchor, literalLength);
+		output += literalLength;
+		return (size_t)(output - target);
+	};
+
+	void PageCodec::Decompress(const uint8_t* compressed, size_t compressedSize, void* startAddress)
+	{
+		auto end = compressed + compressedSize;
+		auto output = (uint8_t*)startAddress;
+
+		while (compressed < end)
+		{
+			auto token = *compressed++;
+			size_t literalLength = token >> 4;
+			if (literalLength == 15)
+				literalLength += ReadLength(compressed);
+			memcpy(output, compressed, literalLength);
+			compressed += literalLength;
+			output += literalLength;
+			if (compressed >= end)
+				break;
+
+			size_t offset = compressed[0] | ((size_t)compressed[1] << 8);
+			compressed += 2;
+			size_t matchLength = token & 15;
+			if (matchLength == 15)
+				matchLength += ReadLength(compressed);
+			matchLength += MinMatch;
+			// the copy may overlap the bytes it makes, so it goes byte by byte
+			auto match = output - offset;
+			for (size_t i = 0; i < matchLength; ++i)
+				output[i] = match[i];
+			output += matchLength;
+		}
+	};
+
+	uint8_t* PageCodec::WriteLength(uint8_t* target, size_t length)
+	{
+		for (; length >= 255; length -= 255)
+			*target++ = 255;
+		*target++ = (uint8_t)length;
+		return target;
+	};
+
+	size_t PageCodec::ReadLength(const uint8_t*& compressed)
+	{
+		size_t length = 0;
+		uint8_t part;
+		do
+		{
+			part = *compressed++;
+			length += part;
+		} while (part == 255);
+		return length;
+	};
+};
\ No newline at end of file
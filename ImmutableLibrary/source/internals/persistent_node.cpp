@@ -0,0 +1,19 @@
+#include "../../headers/internals/persistent_node.h"
+
+namespace immutable::internals
+{
+	PersistentNode::PersistentNode(atomic<size_t>* references)
+	{
+		References = references;
+	};
+
+	void PersistentNode::Acquire()
+	{
+		References->fetch_add(1, memory_order_relaxed);
+	};
+
+	bool PersistentNode::Release()
+	{
+		return References->fetch_sub(1, memory_order_acq_rel) == 1;
+	};
+};
\ No newline at end of file
@@ -0,0 +1,148 @@
+#ifdef __linux__
+
+#include "../../../headers/internals/protectors/memory_protector_dual.h"
+
+namespace immutable::internals::protectors
+{
+	size_t MemoryProtectorDual::GetHugeMemoryPageSize()
+	{
+		return GetMemoryPageSize();
+	};
+
+	void* MemoryProtectorDual::ReserveRegion(size_t regionSize, size_t)
+	{
+		MemoryFile = memfd_create("immutable", MFD_CLOEXEC);
+		if (MemoryFile == -1)
+		{
+			auto message = strerror(errno);
+			throw runtime_error(message);
+		}
+		// the file is sparse, so its size costs nothing until pages are touched
+		auto success = ftruncate(MemoryFile, regionSize);
+		if (success == 0)
+		{
+			auto view = mmap(nullptr, regionSize, PROT_NONE, MAP_SHARED | MAP_NORESERVE, MemoryFile, 0);
+			auto alias = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, MemoryFile, 0);
+			// shared mappings would stay shared with a forked child, whose allocations would then overwrite the objects of the parent, so the child is given its own copy of the memory file
+			if (view != MAP_FAILED && alias != MAP_FAILED && pthread_atfork(nullptr, nullptr, SeparateChild) == 0)
+			{
+				ViewAddress = (char*)view;
+				AliasAddress = (char*)alias;
+				RegionSize = regionSize;
+				return view;
+			}
+		}
+		auto message = strerror(errno);
+		throw runtime_error(message);
+	};
+
+	void MemoryProtectorDual::FreePage(MemoryPage* page)
+	{
+		PunchPage(page->StartAddress, page->TotalSize);
+		auto success = mprotect(page->StartAddress, page->TotalSize, PROT_NONE);
+		if (success == 0)
+			return;
+		auto message = strerror(errno);
+		throw runtime_error(message);
+	};
+
+	void MemoryProtectorDual::PopulateRegion(void* startAddress, size_t regionSize)
+	{
+		auto success = mprotect(startAddress, regionSize, PROT_READ);
+		if (success != 0)
+		{
+			auto message = strerror(errno);
+			throw runtime_error(message);
+		}
+		// the memory is faulted in by writing through the alias, the view only maps the same pages on first read
+		auto alias = (volatile char*)GetWritableAddress(startAddress);
+		auto systemPageSize = GetMemoryPageSize();
+		for (size_t offset = 0; offset < regionSize; offset += systemPageSize)
+			alias[offset] = 0;
+	};
+
+	void MemoryProtectorDual::DiscardPage(MemoryPage* page)
+	{
+		PunchPage(page->StartAddress, page->TotalSize);
+	};
+
+	void MemoryProtectorDual::MovePage(MemoryPage* page, void* startAddress, size_t pageSize)
+	{
+		auto success = mprotect(startAddress, pageSize, PROT_READ);
+		if (success != 0)
+		{
+			auto message = strerror(errno);
+			throw runtime_error(message);
+		}
+		memcpy(GetWritableAddress(startAddress), GetWritableAddress(page->StartAddress), page->TotalSize);
+		FreePage(page);
+		page->StartAddress = startAddress;
+		page->TotalSize = pageSize;
+	};
+
+	void* MemoryProtectorDual::GetWritableAddress(void* address)
+	{
+		return AliasAddress + ((char*)address - ViewAddress);
+	};
+
+	void MemoryProtectorDual::SeparateChild()
+	{
+		if (MemoryFile == -1)
+			return;
+		auto file = memfd_create("immutable", MFD_CLOEXEC);
+		auto success = file != -1 && ftruncate(file, RegionSize) == 0;
+		// only the parts of the memory file holding data are copied, the rest of it stays sparse
+		auto offset = (off_t)0;
+		while (success && (offset = lseek(MemoryFile, offset, SEEK_DATA)) != -1)
+		{
+			auto end = lseek(MemoryFile, offset, SEEK_HOLE);
+			while (success && offset < end)
+			{
+				auto written = pwrite(file, AliasAddress + offset, end - offset, offset);
+				success = written > 0;
+				offset += written;
+			}
+		}
+		// the view keeps the protection of every run of its addresses, so it is mapped again run by run
+		string maps;
+		if (success)
+		{
+			ifstream mapsFile("/proc/self/maps");
+			maps.assign(istreambuf_iterator<char>(mapsFile), istreambuf_iterator<char>());
+		}
+		istringstream lines(maps);
+		string line;
+		while (success && getline(lines, line))
+		{
+			uintptr_t start = 0;
+			uintptr_t end = 0;
+			char permissions[5] = {};
+			if (sscanf(line.c_str(), "%lx-%lx %4s", &start, &end, permissions) != 3 || start < (uintptr_t)ViewAddress || end > (uintptr_t)ViewAddress + RegionSize)
+				continue;
+			auto protection = (permissions[0] == 'r' ? PROT_READ : 0) | (permissions[1] == 'w' ? PROT_WRITE : 0);
+			success = mmap((void*)start, end - start, protection, MAP_SHARED | MAP_FIXED | MAP_NORESERVE, file, (off_t)(start - (uintptr_t)ViewAddress)) != MAP_FAILED;
+		}
+		success = success && mmap(AliasAddress, RegionSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED | MAP_NORESERVE, file, 0) != MAP_FAILED;
+		if (success)
+		{
+			close(MemoryFile);
+			MemoryFile = file;
+			return;
+		}
+		// without a copy the child can still read the objects, but must never write the memory of the parent
+		mprotect(AliasAddress, RegionSize, PROT_NONE);
+		if (file != -1)
+			close(file);
+	};
+
+	void MemoryProtectorDual::PunchPage(void* startAddress, size_t pageSize)
+	{
+		auto offset = (off_t)((char*)startAddress - ViewAddress);
+		auto success = fallocate(MemoryFile, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, offset, pageSize);
+		if (success == 0)
+			return;
+		auto message = strerror(errno);
+		throw runtime_error(message);
+	};
+};
+#endif
\ No newline at end of file
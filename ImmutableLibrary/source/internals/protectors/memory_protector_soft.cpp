@@ -0,0 +1,55 @@
+#include "../../../headers/internals/protectors/memory_protector_soft.h"
+
+namespace immutable::internals::protectors
+{
+	MemoryPage* MemoryProtectorSoft::CatchPage(void* startAddress, size_t pageSize)
+	{
+		auto page = MemoryProtectorHard::CatchPage(startAddress, pageSize);
+		try
+		{
+			// the only change of the protection in the life of the page
+			MemoryProtectorHard::UnlockPage(page);
+		}
+		catch (...)
+		{
+			MemoryProtectorHard::FreePage(page);
+			delete page;
+			throw;
+		}
+		LockPage(page);
+		return page;
+	};
+
+	void MemoryProtectorSoft::ExtendPage(MemoryPage* page, size_t pageSize)
+	{
+		UnlockPage(page);
+		MemoryProtectorHard::ExtendPage(page, pageSize);
+		MemoryProtectorHard::UnlockPage(page);
+		LockPage(page);
+	};
+
+	void MemoryProtectorSoft::MovePage(MemoryPage* page, void* startAddress, size_t pageSize)
+	{
+		UnlockPage(page);
+		MemoryProtectorHard::MovePage(page, startAddress, pageSize);
+		MemoryProtectorHard::UnlockPage(page);
+		LockPage(page);
+	};
+
+	void MemoryProtectorSoft::LockPage(MemoryPage* page)
+	{
+		page->Checksum = PageChecksum::Compute(page->StartAddress, page->TotalSize);
+	};
+
+	void MemoryProtectorSoft::UnlockPage(MemoryPage* page)
+	{
+		constexpr auto sealedPageChanged = "Sealed memory page was changed.";
+		if (!VerifyPage(page))
+			throw runtime_error(sealedPageChanged);
+	};
+
+	bool MemoryProtectorSoft::VerifyPage(MemoryPage* page)
+	{
+		return PageChecksum::Compute(page->StartAddress, page->TotalSize) == page->Checksum;
+	};
+};
\ No newline at end of file
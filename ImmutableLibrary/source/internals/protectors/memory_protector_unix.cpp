@@ -1,6 +1,6 @@
 #ifdef __unix__
 
-#include "..\..\..\headers\internals\protectors\memory_protector_unix.h"
+#include "../../../headers/internals/protectors/memory_protector_unix.h"
 
 namespace immutable::internals::protectors
 {
@@ -9,27 +9,178 @@ namespace immutable::internals::protectors
 		return sysconf(_SC_PAGE_SIZE);
 	};
 
-	MemoryPage* MemoryProtectorUnix::CatchPage(size_t pageSize)
+	size_t MemoryProtectorUnix::GetHugeMemoryPageSize()
 	{
-		auto result = mmap(nullptr, pageSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-		if (result != -1)
-			return new MemoryPage(result, pageSize, 0);
+		ifstream memoryInfo("/proc/meminfo");
+		string key;
+		while (memoryInfo >> key)
+		{
+			size_t sizeInKilobytes = 0;
+			if (key == "Hugepagesize:" && memoryInfo >> sizeInKilobytes)
+				return sizeInKilobytes * 1024;
+			memoryInfo.ignore(numeric_limits<streamsize>::max(), '\n');
+		}
+		return GetMemoryPageSize();
+	};
+
+	void* MemoryProtectorUnix::ReserveRegion(size_t regionSize, size_t pageSize)
+	{
+		if (pageSize <= GetMemoryPageSize())
+		{
+			auto result = mmap(nullptr, regionSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+			if (result != MAP_FAILED)
+				return result;
+			auto message = strerror(errno);
+			throw runtime_error(message);
+		}
+
+		// explicit huge pages are used only if their pool is large enough for the whole region
+		auto result = mmap(nullptr, regionSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (result != MAP_FAILED)
+		{
+			IsHugeTlbRegion = true;
+			return result;
+		}
+
+		// otherwise transparent huge pages are requested for a region aligned to the huge page size
+		auto padded = mmap(nullptr, regionSize + pageSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (padded == MAP_FAILED)
+		{
+			auto message = strerror(errno);
+			throw runtime_error(message);
+		}
+		auto aligned = (char*)(((uintptr_t)padded + pageSize - 1) & ~(uintptr_t)(pageSize - 1));
+		auto headSize = (size_t)(aligned - (char*)padded);
+		if (headSize != 0)
+			munmap(padded, headSize);
+		munmap(aligned + regionSize, pageSize - headSize);
+		// the kernel may have transparent huge pages disabled, then the region just stays with usual pages
+		madvise(aligned, regionSize, MADV_HUGEPAGE);
+		IsTransparentHugeRegion = true;
+		return aligned;
+	};
+
+	MemoryPage* MemoryProtectorUnix::CatchPage(void* startAddress, size_t pageSize)
+	{
+		auto success = mprotect(startAddress, pageSize, PROT_READ);
+		if (success == 0)
+			return new MemoryPage(startAddress, pageSize);
 		auto message = strerror(errno);
 		throw runtime_error(message);
 	};
 
 	void MemoryProtectorUnix::FreePage(MemoryPage* page)
 	{
-		auto success = munmap(page.StartAddress, page.TotalSize);
+		// mapping over explicit huge pages returns them to the pool and leaves the addresses reserved
+		if (IsHugeTlbRegion)
+		{
+			auto result = mmap(page->StartAddress, page->TotalSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_FIXED, -1, 0);
+			if (result != MAP_FAILED)
+				return;
+			auto message = strerror(errno);
+			throw runtime_error(message);
+		}
+		// dropping the memory in place keeps the advice given to the region
+		auto success = madvise(page->StartAddress, page->TotalSize, MADV_DONTNEED);
+		if (success == 0)
+			success = mprotect(page->StartAddress, page->TotalSize, PROT_NONE);
+		if (success == 0)
+			return;
+		auto message = strerror(errno);
+		throw runtime_error(message);
+	};
+
+	void MemoryProtectorUnix::PopulateRegion(void* startAddress, size_t regionSize)
+	{
+		// the memory is populated writable, otherwise reading would only map the shared zero page
+		auto flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_POPULATE | (IsHugeTlbRegion ? MAP_HUGETLB : MAP_NORESERVE);
+		auto result = mmap(startAddress, regionSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+		auto success = (result != MAP_FAILED) ? mprotect(startAddress, regionSize, PROT_READ) : -1;
+		// mapping over the run drops the advice given to the region, so it is given again
+		if (success == 0 && IsTransparentHugeRegion)
+			madvise(startAddress, regionSize, MADV_HUGEPAGE);
+		if (success == 0)
+			return;
+		auto message = strerror(errno);
+		throw runtime_error(message);
+	};
+
+	void MemoryProtectorUnix::DiscardPage(MemoryPage* page)
+	{
+		// explicit huge pages cannot be freed lazily and stay with the page
+		if (IsHugeTlbRegion)
+			return;
+#ifdef MADV_FREE
+		auto success = madvise(page->StartAddress, page->TotalSize, MADV_FREE);
+#else
+		auto success = madvise(page->StartAddress, page->TotalSize, MADV_DONTNEED);
+#endif
 		if (success == 0)
 			return;
 		auto message = strerror(errno);
 		throw runtime_error(message);
 	};
 
+	void MemoryProtectorUnix::ExtendPage(MemoryPage* page, size_t pageSize)
+	{
+		auto success = mprotect((char*)page->StartAddress + page->TotalSize, pageSize - page->TotalSize, PROT_READ);
+		if (success != 0)
+		{
+			auto message = strerror(errno);
+			throw runtime_error(message);
+		}
+		page->TotalSize = pageSize;
+	};
+
+	void MemoryProtectorUnix::MovePage(MemoryPage* page, void* startAddress, size_t pageSize)
+	{
+#ifdef __linux__
+		// the system moves the memory itself, the added tail is new memory with the same protection
+		auto result = mremap(page->StartAddress, page->TotalSize, pageSize, MREMAP_MAYMOVE | MREMAP_FIXED, startAddress);
+		if (result != MAP_FAILED)
+		{
+			// the old addresses are left unmapped, so they are reserved again for the region
+			auto flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | (IsHugeTlbRegion ? MAP_HUGETLB : MAP_NORESERVE);
+			result = mmap(page->StartAddress, page->TotalSize, PROT_NONE, flags, -1, 0);
+			if (result == MAP_FAILED)
+			{
+				auto message = strerror(errno);
+				throw runtime_error(message);
+			}
+			if (IsTransparentHugeRegion)
+				madvise(page->StartAddress, page->TotalSize, MADV_HUGEPAGE);
+			page->StartAddress = startAddress;
+			page->TotalSize = pageSize;
+			return;
+		}
+		// a page grown in place over addresses mapped anew before may span several mappings, which the system cannot move at once
+		if (errno != EFAULT)
+		{
+			auto message = strerror(errno);
+			throw runtime_error(message);
+		}
+#endif
+		auto success = mprotect(startAddress, pageSize, PROT_READ | PROT_WRITE);
+		if (success != 0)
+		{
+			auto message = strerror(errno);
+			throw runtime_error(message);
+		}
+		memcpy(startAddress, page->StartAddress, page->TotalSize);
+		success = mprotect(startAddress, pageSize, PROT_READ);
+		if (success != 0)
+		{
+			auto message = strerror(errno);
+			throw runtime_error(message);
+		}
+		FreePage(page);
+		page->StartAddress = startAddress;
+		page->TotalSize = pageSize;
+	};
+
 	void MemoryProtectorUnix::LockPage(MemoryPage* page)
 	{
-		auto success = mprotect(page.StartAddress, page.TotalSize, PROT_READ);
+		auto success = mprotect(page->StartAddress, page->TotalSize, PROT_READ);
 		if (success == 0)
 			return;
 		auto message = strerror(errno);
@@ -38,11 +189,209 @@ namespace immutable::internals::protectors
 
 	void MemoryProtectorUnix::UnlockPage(MemoryPage* page)
 	{
-		auto success = mprotect(page.StartAddress, page.TotalSize, PROT_READ | PROT_WRITE);
+		auto success = mprotect(page->StartAddress, page->TotalSize, PROT_READ | PROT_WRITE);
+		if (success == 0)
+			return;
+		auto message = strerror(errno);
+		throw runtime_error(message);
+	};
+
+	void* MemoryProtectorUnix::MapFile(const string& path, size_t& fileSize)
+	{
+		auto descriptor = open(path.c_str(), O_RDONLY);
+		if (descriptor == -1)
+		{
+			auto message = strerror(errno);
+			throw runtime_error(message);
+		}
+		// the mapping keeps its own reference to the file, so the descriptor is closed in any case
+		try
+		{
+			auto result = MapDescriptor(descriptor, fileSize);
+			close(descriptor);
+			return result;
+		}
+		catch (...)
+		{
+			close(descriptor);
+			throw;
+		}
+	};
+
+	void MemoryProtectorUnix::UnmapFile(void* startAddress, size_t fileSize)
+	{
+		auto success = munmap(startAddress, fileSize);
+		if (success == 0)
+			return;
+		auto message = strerror(errno);
+		throw runtime_error(message);
+	};
+
+	void* MemoryProtectorUnix::GetWritableAddress(void*)
+	{
+		return nullptr;
+	};
+
+#ifdef __linux__
+	int MemoryProtectorUnix::CreateSealedMemory(const void* contents, size_t contentsSize)
+	{
+		auto sealedMemory = memfd_create("immutable", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+		if (sealedMemory == -1)
+		{
+			auto message = strerror(errno);
+			throw runtime_error(message);
+		}
+		auto writtenSize = (size_t)0;
+		while (writtenSize < contentsSize)
+		{
+			auto result = write(sealedMemory, (const char*)contents + writtenSize, contentsSize - writtenSize);
+			if (result <= 0)
+				break;
+			writtenSize += result;
+		}
+		// the seals themselves are sealed as well, so they can never be removed
+		auto seals = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL;
+		if (writtenSize == contentsSize && fcntl(sealedMemory, F_ADD_SEALS, seals) == 0)
+			return sealedMemory;
+		auto message = strerror(errno);
+		close(sealedMemory);
+		throw runtime_error(message);
+	};
+
+	void* MemoryProtectorUnix::MapSealedMemory(int sealedMemory, size_t& memorySize)
+	{
+		constexpr auto notSealed = "Shared memory is not sealed.";
+		auto requiredSeals = F_SEAL_SHRINK | F_SEAL_WRITE;
+		auto seals = fcntl(sealedMemory, F_GET_SEALS);
+		if (seals == -1 || (seals & requiredSeals) != requiredSeals)
+			throw runtime_error(notSealed);
+		return MapDescriptor(sealedMemory, memorySize);
+	};
+
+	void MemoryProtectorUnix::HidePage(MemoryPage* page)
+	{
+		// access is forbidden first, so that no one reads the memory while it is being dropped
+		auto success = mprotect(page->StartAddress, page->TotalSize, PROT_NONE);
+		if (success == 0)
+			success = madvise(page->StartAddress, page->TotalSize, MADV_DONTNEED);
+		if (success == 0)
+			return;
+		auto message = strerror(errno);
+		throw runtime_error(message);
+	};
+
+	void* MemoryProtectorUnix::MapScratch(size_t size)
+	{
+		auto flags = MAP_PRIVATE | MAP_ANONYMOUS | (IsHugeTlbRegion ? MAP_HUGETLB : MAP_NORESERVE);
+		auto result = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+		if (result != MAP_FAILED)
+			return result;
+		auto message = strerror(errno);
+		throw runtime_error(message);
+	};
+
+	void MemoryProtectorUnix::ReplacePage(MemoryPage* page, void* scratch)
+	{
+		// moving the memory over the page replaces its mapping in one step, readers either fault or see all the contents
+		auto success = mprotect(scratch, page->TotalSize, PROT_READ);
+		if (success == 0 && mremap(scratch, page->TotalSize, page->TotalSize, MREMAP_MAYMOVE | MREMAP_FIXED, page->StartAddress) == MAP_FAILED)
+			success = -1;
+		// mapping over the page drops the advice given to the region, so it is given again
+		if (success == 0 && IsTransparentHugeRegion)
+			madvise(page->StartAddress, page->TotalSize, MADV_HUGEPAGE);
+		if (success == 0)
+			return;
+		auto message = strerror(errno);
+		throw runtime_error(message);
+	};
+
+	void MemoryProtectorUnix::HandleFaults(bool (*handler)(void* address))
+	{
+		FaultHandler = handler;
+		struct sigaction action = {};
+		action.sa_sigaction = HandleFault;
+		// the handler installed before may leave by an exception, so the signal must not stay blocked after it
+		action.sa_flags = SA_SIGINFO | SA_NODEFER;
+		sigemptyset(&action.sa_mask);
+		auto success = sigaction(SIGSEGV, &action, &PreviousFaultAction);
 		if (success == 0)
 			return;
 		auto message = strerror(errno);
 		throw runtime_error(message);
 	};
+
+	void MemoryProtectorUnix::HandleFault(int signalNumber, siginfo_t* signalInfo, void* context)
+	{
+		if (FaultHandler(signalInfo->si_addr))
+			return;
+		if ((PreviousFaultAction.sa_flags & SA_SIGINFO) != 0)
+			return PreviousFaultAction.sa_sigaction(signalNumber, signalInfo, context);
+		if (PreviousFaultAction.sa_handler != SIG_DFL && PreviousFaultAction.sa_handler != SIG_IGN)
+			return PreviousFaultAction.sa_handler(signalNumber);
+		// the default action is restored, so the access faults again and ends the process as it would have without the allocator
+		signal(SIGSEGV, SIG_DFL);
+	};
+#endif
+
+	void MemoryProtectorUnix::SendDescriptor(int socket, int descriptor)
+	{
+		// at least one byte of data has to be sent along with the descriptor
+		char data = 0;
+		iovec dataVector = { &data, sizeof(data) };
+		char control[CMSG_SPACE(sizeof(int))] = {};
+		msghdr message = {};
+		message.msg_iov = &dataVector;
+		message.msg_iovlen = 1;
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+		auto header = CMSG_FIRSTHDR(&message);
+		header->cmsg_level = SOL_SOCKET;
+		header->cmsg_type = SCM_RIGHTS;
+		header->cmsg_len = CMSG_LEN(sizeof(int));
+		memcpy(CMSG_DATA(header), &descriptor, sizeof(int));
+		if (sendmsg(socket, &message, 0) == sizeof(data))
+			return;
+		auto error = strerror(errno);
+		throw runtime_error(error);
+	};
+
+	int MemoryProtectorUnix::ReceiveDescriptor(int socket)
+	{
+		constexpr auto notReceived = "Descriptor is not received.";
+		char data = 0;
+		iovec dataVector = { &data, sizeof(data) };
+		char control[CMSG_SPACE(sizeof(int))] = {};
+		msghdr message = {};
+		message.msg_iov = &dataVector;
+		message.msg_iovlen = 1;
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+		if (recvmsg(socket, &message, MSG_CMSG_CLOEXEC) != sizeof(data))
+		{
+			auto error = strerror(errno);
+			throw runtime_error(error);
+		}
+		auto header = CMSG_FIRSTHDR(&message);
+		if (header == nullptr || header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS)
+			throw runtime_error(notReceived);
+		int descriptor;
+		memcpy(&descriptor, CMSG_DATA(header), sizeof(int));
+		return descriptor;
+	};
+
+	void* MemoryProtectorUnix::MapDescriptor(int descriptor, size_t& fileSize)
+	{
+		struct stat status;
+		void* result = MAP_FAILED;
+		if (fstat(descriptor, &status) == 0)
+			result = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+		if (result != MAP_FAILED)
+		{
+			fileSize = status.st_size;
+			return result;
+		}
+		auto message = strerror(errno);
+		throw runtime_error(message);
+	};
 };
 #endif
\ No newline at end of file
@@ -1,6 +1,6 @@
 #ifdef _WIN32
 
-#include "..\..\..\headers\internals\protectors\memory_protector_windows.h"
+#include "../../../headers/internals/protectors/memory_protector_windows.h"
 
 namespace immutable::internals::protectors
 {
@@ -11,9 +11,27 @@ namespace immutable::internals::protectors
 		return siSysInfo.dwPageSize;
 	};
 
-	MemoryPage* MemoryProtectorWindows::CatchPage(size_t pageSize)
+	size_t MemoryProtectorWindows::GetHugeMemoryPageSize()
 	{
-		auto result = VirtualAlloc(nullptr, pageSize, MEM_COMMIT | MEM_RESERVE, PAGE_READONLY);
+		auto result = GetLargePageMinimum();
+		if (result != 0)
+			return result;
+		return GetMemoryPageSize();
+	};
+
+	void* MemoryProtectorWindows::ReserveRegion(size_t regionSize, size_t pageSize)
+	{
+		// large pages cannot be committed into a reserved region, so only the granularity of pages follows the huge page size
+		auto result = VirtualAlloc(nullptr, regionSize + pageSize, MEM_RESERVE, PAGE_NOACCESS);
+		if (result != nullptr)
+			return (void*)(((uintptr_t)result + pageSize - 1) & ~(uintptr_t)(pageSize - 1));
+		auto message = system_category().message(::GetLastError());
+		throw runtime_error(message);
+	};
+
+	MemoryPage* MemoryProtectorWindows::CatchPage(void* startAddress, size_t pageSize)
+	{
+		auto result = VirtualAlloc(startAddress, pageSize, MEM_COMMIT, PAGE_READONLY);
 		if (result != nullptr)			
 			return new MemoryPage(result, pageSize);
 		auto message = system_category().message(::GetLastError());
@@ -22,13 +40,42 @@ namespace immutable::internals::protectors
 
 	void MemoryProtectorWindows::FreePage(MemoryPage* page)
 	{
-		auto success = VirtualFree(page->StartAddress, 0, MEM_RELEASE);
+		auto success = VirtualFree(page->StartAddress, page->TotalSize, MEM_DECOMMIT);
+		if (success != 0)
+			return;
+		auto message = system_category().message(::GetLastError());
+		throw runtime_error(message);
+	};
+
+	void MemoryProtectorWindows::PopulateRegion(void* startAddress, size_t regionSize)
+	{
+		auto result = VirtualAlloc(startAddress, regionSize, MEM_COMMIT, PAGE_READWRITE);
+		if (result == nullptr)
+		{
+			auto message = system_category().message(::GetLastError());
+			throw runtime_error(message);
+		}
+		// committed memory is only backed on first touch, so every system page is touched by writing
+		auto systemPageSize = GetMemoryPageSize();
+		for (size_t offset = 0; offset < regionSize; offset += systemPageSize)
+			((volatile char*)startAddress)[offset] = 0;
+		DWORD old;
+		auto success = VirtualProtect(startAddress, regionSize, PAGE_READONLY, &old);
 		if (success != 0)
 			return;
 		auto message = system_category().message(::GetLastError());
 		throw runtime_error(message);
 	};
 
+	void MemoryProtectorWindows::DiscardPage(MemoryPage* page)
+	{
+		auto result = VirtualAlloc(page->StartAddress, page->TotalSize, MEM_RESET, PAGE_NOACCESS);
+		if (result != nullptr)
+			return;
+		auto message = system_category().message(::GetLastError());
+		throw runtime_error(message);
+	};
+
 	void MemoryProtectorWindows::LockPage(MemoryPage* page)
 	{
 		DWORD old;
@@ -39,6 +86,39 @@ namespace immutable::internals::protectors
 		throw runtime_error(message);
 	};
 
+	void MemoryProtectorWindows::ExtendPage(MemoryPage* page, size_t pageSize)
+	{
+		auto result = VirtualAlloc((char*)page->StartAddress + page->TotalSize, pageSize - page->TotalSize, MEM_COMMIT, PAGE_READONLY);
+		if (result == nullptr)
+		{
+			auto message = system_category().message(::GetLastError());
+			throw runtime_error(message);
+		}
+		page->TotalSize = pageSize;
+	};
+
+	void MemoryProtectorWindows::MovePage(MemoryPage* page, void* startAddress, size_t pageSize)
+	{
+		// the system cannot move committed memory, so it is copied
+		auto result = VirtualAlloc(startAddress, pageSize, MEM_COMMIT, PAGE_READWRITE);
+		if (result == nullptr)
+		{
+			auto message = system_category().message(::GetLastError());
+			throw runtime_error(message);
+		}
+		memcpy(startAddress, page->StartAddress, page->TotalSize);
+		DWORD old;
+		auto success = VirtualProtect(startAddress, pageSize, PAGE_READONLY, &old);
+		if (success == 0)
+		{
+			auto message = system_category().message(::GetLastError());
+			throw runtime_error(message);
+		}
+		FreePage(page);
+		page->StartAddress = startAddress;
+		page->TotalSize = pageSize;
+	};
+
 	void MemoryProtectorWindows::UnlockPage(MemoryPage* page)
 	{
 		DWORD old;
@@ -48,5 +128,48 @@ namespace immutable::internals::protectors
 		auto message = system_category().message(::GetLastError());
 		throw runtime_error(message);
 	};
+
+	void* MemoryProtectorWindows::MapFile(const string& path, size_t& fileSize)
+	{
+		auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			auto message = system_category().message(::GetLastError());
+			throw runtime_error(message);
+		}
+		// the view keeps its own references to the file and the mapping, so the handles are closed in any case
+		LARGE_INTEGER size;
+		HANDLE mapping = nullptr;
+		void* result = nullptr;
+		if (GetFileSizeEx(file, &size) != 0)
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping != nullptr)
+			result = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		auto error = ::GetLastError();
+		if (mapping != nullptr)
+			CloseHandle(mapping);
+		CloseHandle(file);
+		if (result != nullptr)
+		{
+			fileSize = (size_t)size.QuadPart;
+			return result;
+		}
+		auto message = system_category().message(error);
+		throw runtime_error(message);
+	};
+
+	void MemoryProtectorWindows::UnmapFile(void* startAddress, size_t fileSize)
+	{
+		auto success = UnmapViewOfFile(startAddress);
+		if (success != 0)
+			return;
+		auto message = system_category().message(::GetLastError());
+		throw runtime_error(message);
+	};
+
+	void* MemoryProtectorWindows::GetWritableAddress(void* address)
+	{
+		return nullptr;
+	};
 };
 #endif
\ No newline at end of file
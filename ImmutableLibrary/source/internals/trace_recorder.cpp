@@ -0,0 +1,108 @@
+#include "../../headers/internals/trace_recorder.h"
+
+namespace immutable::internals
+{
+	void TraceRecorder::Start(const string& path)
+	{
+		const lock_guard<mutex> guard(FileMutex);
+		constexpr auto alreadyRecording = "Trace is already recording.";
+		constexpr auto notOpened = "Trace file is not opened.";
+		if (IsRecording.load(memory_order_relaxed))
+			throw runtime_error(alreadyRecording);
+		File.open(path, ios::binary | ios::trunc);
+		if (!File)
+			throw runtime_error(notOpened);
+		TraceHeader header;
+		header.Signature = FormatSignature;
+		header.Version = FormatVersion;
+		File.write((const char*)&header, sizeof(header));
+		StartTime = chrono::steady_clock::now();
+		IsRecording.store(true, memory_order_release);
+	};
+
+	void TraceRecorder::Stop()
+	{
+		// calls made after this are dropped, since every thread checks the sign again under the lock of its buffer
+		IsRecording.store(false, memory_order_release);
+		list<shared_ptr<ThreadBuffer>> buffers;
+		{
+			const lock_guard<mutex> guard(FileMutex);
+			buffers = Buffers;
+		}
+		for (auto& buffer : buffers)
+		{
+			const lock_guard<mutex> guard(buffer->Mutex);
+			WriteBuffer(*buffer);
+		}
+		buffers.clear();
+
+		const lock_guard<mutex> guard(FileMutex);
+		constexpr auto notWritten = "Trace file is not written.";
+		auto isWritten = !File.fail();
+		if (File.is_open())
+			File.close();
+		// buffers of finished threads are held only by the list, so they are dropped with the recording
+		Buffers.remove_if([](const shared_ptr<ThreadBuffer>& buffer) { return buffer.use_count() == 1; });
+		if (!isWritten)
+			throw runtime_error(notWritten);
+	};
+
+	void TraceRecorder::Record(TraceOperation operation, const void* address, size_t size, size_t count)
+	{
+		auto& buffer = GetThreadBuffer();
+		const lock_guard<mutex> guard(buffer.Mutex);
+		if (!IsRecording.load(memory_order_acquire))
+			return;
+		TraceRecord record;
+		record.Nanoseconds = (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - StartTime).count();
+		record.Address = (uint64_t)(uintptr_t)address;
+		record.Size = (uint32_t)size;
+		record.Count = (uint32_t)count;
+		record.Thread = buffer.Thread;
+		record.Operation = operation;
+		buffer.Records.push_back(record);
+		if (buffer.Records.size() >= BufferSize)
+			WriteBuffer(buffer);
+	};
+
+	vector<TraceRecord> TraceRecorder::Load(const string& path)
+	{
+		constexpr auto notOpened = "Trace file is not opened.";
+		constexpr auto corruptedFile = "Trace file is corrupted.";
+		ifstream file(path, ios::binary);
+		if (!file)
+			throw runtime_error(notOpened);
+		TraceHeader header;
+		if (!file.read((char*)&header, sizeof(header)) || header.Signature != FormatSignature || header.Version != FormatVersion)
+			throw runtime_error(corruptedFile);
+		vector<TraceRecord> result;
+		TraceRecord record;
+		while (file.read((char*)&record, sizeof(record)))
+			result.push_back(record);
+		// a record cut short means the file was not written to the end
+		if (file.gcount() != 0)
+			throw runtime_error(corruptedFile);
+		return result;
+	};
+
+	TraceRecorder::ThreadBuffer& TraceRecorder::GetThreadBuffer()
+	{
+		static thread_local shared_ptr<ThreadBuffer> buffer;
+		if (buffer != nullptr)
+			return *buffer;
+		buffer = make_shared<ThreadBuffer>();
+		buffer->Records.reserve(BufferSize);
+		const lock_guard<mutex> guard(FileMutex);
+		buffer->Thread = NextThread++;
+		Buffers.push_back(buffer);
+		return *buffer;
+	};
+
+	void TraceRecorder::WriteBuffer(ThreadBuffer& buffer)
+	{
+		const lock_guard<mutex> guard(FileMutex);
+		if (File.is_open() && !buffer.Records.empty())
+			File.write((const char*)buffer.Records.data(), buffer.Records.size() * sizeof(TraceRecord));
+		buffer.Records.clear();
+	};
+};
\ No newline at end of file
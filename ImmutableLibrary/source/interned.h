@@ -0,0 +1,49 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	template<class T> Interned<T>::Entry::Entry(size_t hashCode, T&& value) : HashCode(hashCode), Value(move(value))
+	{
+	};
+
+	template<class T> Interned<T>::Interned() : Interned(nullptr)
+	{
+	};
+
+	template<class T> Interned<T>::Interned(const Entry* target)
+	{
+		Target = target;
+	};
+
+	template<class T> const T* Interned<T>::get() const
+	{
+		return (Target == nullptr) ? nullptr : &Target->Value;
+	};
+
+	template<class T> const T& Interned<T>::operator*() const
+	{
+		return Target->Value;
+	};
+
+	template<class T> const T* Interned<T>::operator->() const
+	{
+		return &Target->Value;
+	};
+
+	template<class T> size_t Interned<T>::hash() const
+	{
+		return Target->HashCode;
+	};
+
+	template<class T> bool Interned<T>::operator==(const Interned& other) const
+	{
+		return Target == other.Target;
+	};
+
+	template<class T> Interned<T>::operator bool() const
+	{
+		return Target != nullptr;
+	};
+};
\ No newline at end of file
@@ -0,0 +1,363 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	template<class K, class V, class Hash> class PersistentMap<K, V, Hash>::Entry
+	{
+	public:
+		// Initialization of fields with copies of the key and the value.
+		Entry(const K& key, const V& value) : Key(key), Value(value)
+		{
+		};
+
+		// The key of the entry.
+		K Key;
+
+		// The value bound to the key.
+		V Value;
+	};
+
+	template<class K, class V, class Hash> class PersistentMap<K, V, Hash>::Node : public PersistentNode
+	{
+	public:
+		// Initialization of fields with already initialized entries and children already referenced for the node.
+		Node(atomic<size_t>* references, uint32_t dataMap, uint32_t nodeMap, Entry* entries, size_t entriesCount, Node** children, size_t childrenCount) : PersistentNode(references)
+		{
+			DataMap = dataMap;
+			NodeMap = nodeMap;
+			Entries = entries;
+			EntriesCount = entriesCount;
+			Children = children;
+			ChildrenCount = childrenCount;
+		};
+
+		// Bits set for the hash parts of the level that select an entry.
+		uint32_t DataMap;
+
+		// Bits set for the hash parts of the level that select a child.
+		uint32_t NodeMap;
+
+		// The entries located in immutable memory in the order of the bits (or in any order below the last level).
+		Entry* Entries;
+
+		// Count of the entries.
+		size_t EntriesCount;
+
+		// The nodes of the level below located in immutable memory in the order of the bits.
+		Node** Children;
+
+		// Count of the children.
+		size_t ChildrenCount;
+	};
+
+	template<class K, class V, class Hash> PersistentMap<K, V, Hash>::PersistentMap() : PersistentMap(nullptr, 0)
+	{
+	};
+
+	template<class K, class V, class Hash> PersistentMap<K, V, Hash>::PersistentMap(Node* root, size_t count)
+	{
+		Root = root;
+		Count = count;
+	};
+
+	template<class K, class V, class Hash> PersistentMap<K, V, Hash>::PersistentMap(const PersistentMap& other) : PersistentMap(other.Root, other.Count)
+	{
+		if (Root != nullptr)
+			Root->Acquire();
+	};
+
+	template<class K, class V, class Hash> PersistentMap<K, V, Hash>::PersistentMap(PersistentMap&& other) noexcept : PersistentMap(other.Root, other.Count)
+	{
+		other.Root = nullptr;
+		other.Count = 0;
+	};
+
+	template<class K, class V, class Hash> PersistentMap<K, V, Hash>& PersistentMap<K, V, Hash>::operator=(PersistentMap other) noexcept
+	{
+		swap(Root, other.Root);
+		swap(Count, other.Count);
+		return *this;
+	};
+
+	template<class K, class V, class Hash> PersistentMap<K, V, Hash>::~PersistentMap()
+	{
+		ReleaseNode(Root);
+	};
+
+	template<class K, class V, class Hash> size_t PersistentMap<K, V, Hash>::size() const
+	{
+		return Count;
+	};
+
+	template<class K, class V, class Hash> bool PersistentMap<K, V, Hash>::empty() const
+	{
+		return Count == 0;
+	};
+
+	template<class K, class V, class Hash> const V* PersistentMap<K, V, Hash>::find(const K& key) const
+	{
+		auto hashCode = Hash()(key);
+		auto node = Root;
+		for (size_t shift = 0; node != nullptr; shift += LevelBits)
+		{
+			if (shift >= HashBits)
+			{
+				for (size_t i = 0; i < node->EntriesCount; ++i)
+					if (node->Entries[i].Key == key)
+						return &node->Entries[i].Value;
+				return nullptr;
+			}
+
+			auto bit = GetBit(hashCode, shift);
+			if ((node->DataMap & bit) != 0)
+			{
+				auto& entry = node->Entries[popcount(node->DataMap & (bit - 1))];
+				return (entry.Key == key) ? &entry.Value : nullptr;
+			}
+			if ((node->NodeMap & bit) == 0)
+				return nullptr;
+			node = node->Children[popcount(node->NodeMap & (bit - 1))];
+		}
+		return nullptr;
+	};
+
+	template<class K, class V, class Hash> bool PersistentMap<K, V, Hash>::contains(const K& key) const
+	{
+		return find(key) != nullptr;
+	};
+
+	template<class K, class V, class Hash> PersistentMap<K, V, Hash> PersistentMap<K, V, Hash>::set(const K& key, const V& value) const
+	{
+		ImmutableBatch batch;
+		auto hashCode = Hash()(key);
+		if (Root == nullptr)
+			return PersistentMap(MakeNode(GetBit(hashCode, 0), 0, { EntrySource(&key, &value) }, {}, nullptr), 1);
+
+		auto isAdded = false;
+		auto root = InsertNode(Root, 0, hashCode, key, value, isAdded);
+		return PersistentMap(root, isAdded ? Count + 1 : Count);
+	};
+
+	template<class K, class V, class Hash> PersistentMap<K, V, Hash> PersistentMap<K, V, Hash>::erase(const K& key) const
+	{
+		ImmutableBatch batch;
+		auto isRemoved = false;
+		auto root = RemoveNode(Root, 0, Hash()(key), key, isRemoved);
+		if (!isRemoved)
+			return *this;
+		return PersistentMap(root, Count - 1);
+	};
+
+	template<class K, class V, class Hash> uint32_t PersistentMap<K, V, Hash>::GetBit(size_t hashCode, size_t shift)
+	{
+		return (uint32_t)1 << ((hashCode >> shift) & (((size_t)1 << LevelBits) - 1));
+	};
+
+	template<class K, class V, class Hash> typename PersistentMap<K, V, Hash>::Node* PersistentMap<K, V, Hash>::MakeNode(uint32_t dataMap, uint32_t nodeMap, const vector<EntrySource>& entries, const vector<Node*>& children, Node* owned)
+	{
+		Entry* entriesArray = nullptr;
+		Node** childrenArray = nullptr;
+		size_t constructedEntries = 0;
+		size_t constructedChildren = 0;
+		try
+		{
+			if (!entries.empty())
+			{
+				entriesArray = ImmutableAllocator<Entry>::allocate(entries.size());
+				for (; constructedEntries < entries.size(); ++constructedEntries)
+					ImmutableAllocator<Entry>::construct(entriesArray + constructedEntries, *entries[constructedEntries].first, *entries[constructedEntries].second);
+			}
+			if (!children.empty())
+			{
+				childrenArray = ImmutableAllocator<Node*>::allocate(children.size());
+				for (; constructedChildren < children.size(); ++constructedChildren)
+					ImmutableAllocator<Node*>::construct(childrenArray + constructedChildren, children[constructedChildren]);
+			}
+			auto node = ImmutableAllocator<Node>::allocate(1);
+			atomic<size_t>* references = nullptr;
+			try
+			{
+				// the counter is kept by the page of the node, so a node costs a single allocation
+				references = ImmutableAllocator<Node>::CreateReferenceCount(node);
+				ImmutableAllocator<Node>::construct(node, references, dataMap, nodeMap, entriesArray, entries.size(), childrenArray, children.size());
+			}
+			catch (...)
+			{
+				if (references != nullptr)
+					ImmutableAllocator<Node>::ReleaseReferenceCount(node);
+				ImmutableAllocator<Node>::deallocate(node, 1);
+				throw;
+			}
+			for (auto child : children)
+				if (child != owned)
+					child->Acquire();
+			return node;
+		}
+		catch (...)
+		{
+			if (constructedEntries != 0)
+				ImmutableAllocator<Entry>::destroy_n(entriesArray, constructedEntries);
+			if (entriesArray != nullptr)
+				ImmutableAllocator<Entry>::deallocate(entriesArray, entries.size());
+			if (constructedChildren != 0)
+				ImmutableAllocator<Node*>::destroy_n(childrenArray, constructedChildren);
+			if (childrenArray != nullptr)
+				ImmutableAllocator<Node*>::deallocate(childrenArray, children.size());
+			ReleaseNode(owned);
+			throw;
+		}
+	};
+
+	template<class K, class V, class Hash> typename PersistentMap<K, V, Hash>::Node* PersistentMap<K, V, Hash>::MergeEntries(EntrySource first, size_t firstHash, EntrySource second, size_t secondHash, size_t shift)
+	{
+		if (shift >= HashBits)
+			return MakeNode(0, 0, { first, second }, {}, nullptr);
+
+		auto firstBit = GetBit(firstHash, shift);
+		auto secondBit = GetBit(secondHash, shift);
+		if (firstBit == secondBit)
+		{
+			auto child = MergeEntries(first, firstHash, second, secondHash, shift + LevelBits);
+			return MakeNode(0, firstBit, {}, { child }, child);
+		}
+		if (firstBit < secondBit)
+			return MakeNode(firstBit | secondBit, 0, { first, second }, {}, nullptr);
+		return MakeNode(firstBit | secondBit, 0, { second, first }, {}, nullptr);
+	};
+
+	template<class K, class V, class Hash> typename PersistentMap<K, V, Hash>::Node* PersistentMap<K, V, Hash>::InsertNode(Node* node, size_t shift, size_t hashCode, const K& key, const V& value, bool& isAdded)
+	{
+		auto entries = ListEntries(node);
+		auto children = ListChildren(node);
+
+		// below the last level the keys with equal hashes are simply listed
+		if (shift >= HashBits)
+		{
+			auto it = find_if(entries.begin(), entries.end(), [&key](const EntrySource& entry) { return *entry.first == key; });
+			if (it != entries.end())
+				it->second = &value;
+			else
+			{
+				entries.push_back(EntrySource(&key, &value));
+				isAdded = true;
+			}
+			return MakeNode(0, 0, entries, children, nullptr);
+		}
+
+		auto bit = GetBit(hashCode, shift);
+		auto entryPosition = (size_t)popcount(node->DataMap & (bit - 1));
+		auto childPosition = (size_t)popcount(node->NodeMap & (bit - 1));
+		if ((node->DataMap & bit) != 0)
+		{
+			auto& entry = node->Entries[entryPosition];
+			if (entry.Key == key)
+			{
+				entries[entryPosition].second = &value;
+				return MakeNode(node->DataMap, node->NodeMap, entries, children, nullptr);
+			}
+
+			// an entry of another key in the place is moved down together with the new one
+			auto child = MergeEntries(EntrySource(&entry.Key, &entry.Value), Hash()(entry.Key), EntrySource(&key, &value), hashCode, shift + LevelBits);
+			isAdded = true;
+			entries.erase(entries.begin() + entryPosition);
+			children.insert(children.begin() + childPosition, child);
+			return MakeNode(node->DataMap ^ bit, node->NodeMap | bit, entries, children, child);
+		}
+		if ((node->NodeMap & bit) != 0)
+		{
+			auto child = InsertNode(node->Children[childPosition], shift + LevelBits, hashCode, key, value, isAdded);
+			children[childPosition] = child;
+			return MakeNode(node->DataMap, node->NodeMap, entries, children, child);
+		}
+		isAdded = true;
+		entries.insert(entries.begin() + entryPosition, EntrySource(&key, &value));
+		return MakeNode(node->DataMap | bit, node->NodeMap, entries, children, nullptr);
+	};
+
+	template<class K, class V, class Hash> typename PersistentMap<K, V, Hash>::Node* PersistentMap<K, V, Hash>::RemoveNode(Node* node, size_t shift, size_t hashCode, const K& key, bool& isRemoved)
+	{
+		if (node == nullptr)
+			return nullptr;
+
+		auto entries = ListEntries(node);
+		auto children = ListChildren(node);
+		if (shift >= HashBits)
+		{
+			auto it = find_if(entries.begin(), entries.end(), [&key](const EntrySource& entry) { return *entry.first == key; });
+			if (it == entries.end())
+				return node;
+			isRemoved = true;
+			if (entries.size() == 1)
+				return nullptr;
+			entries.erase(it);
+			return MakeNode(0, 0, entries, children, nullptr);
+		}
+
+		auto bit = GetBit(hashCode, shift);
+		auto entryPosition = (size_t)popcount(node->DataMap & (bit - 1));
+		auto childPosition = (size_t)popcount(node->NodeMap & (bit - 1));
+		if ((node->DataMap & bit) != 0)
+		{
+			if (!(node->Entries[entryPosition].Key == key))
+				return node;
+			isRemoved = true;
+			if (entries.size() == 1 && children.empty())
+				return nullptr;
+			entries.erase(entries.begin() + entryPosition);
+			return MakeNode(node->DataMap ^ bit, node->NodeMap, entries, children, nullptr);
+		}
+		if ((node->NodeMap & bit) == 0)
+			return node;
+
+		auto child = RemoveNode(node->Children[childPosition], shift + LevelBits, hashCode, key, isRemoved);
+		if (!isRemoved)
+			return node;
+		if (child != nullptr)
+		{
+			children[childPosition] = child;
+			return MakeNode(node->DataMap, node->NodeMap, entries, children, child);
+		}
+		if (entries.empty() && children.size() == 1)
+			return nullptr;
+		children.erase(children.begin() + childPosition);
+		return MakeNode(node->DataMap, node->NodeMap ^ bit, entries, children, nullptr);
+	};
+
+	template<class K, class V, class Hash> vector<typename PersistentMap<K, V, Hash>::EntrySource> PersistentMap<K, V, Hash>::ListEntries(const Node* node)
+	{
+		vector<EntrySource> result;
+		result.reserve(node->EntriesCount + 1);
+		for (size_t i = 0; i < node->EntriesCount; ++i)
+			result.push_back(EntrySource(&node->Entries[i].Key, &node->Entries[i].Value));
+		return result;
+	};
+
+	template<class K, class V, class Hash> vector<typename PersistentMap<K, V, Hash>::Node*> PersistentMap<K, V, Hash>::ListChildren(const Node* node)
+	{
+		return vector<Node*>(node->Children, node->Children + node->ChildrenCount);
+	};
+
+	template<class K, class V, class Hash> void PersistentMap<K, V, Hash>::ReleaseNode(Node* node)
+	{
+		if (node == nullptr || !node->Release())
+			return;
+
+		for (size_t i = 0; i < node->ChildrenCount; ++i)
+			ReleaseNode(node->Children[i]);
+		if (node->EntriesCount != 0)
+		{
+			ImmutableAllocator<Entry>::destroy_n(node->Entries, node->EntriesCount);
+			ImmutableAllocator<Entry>::deallocate(node->Entries, node->EntriesCount);
+		}
+		if (node->ChildrenCount != 0)
+		{
+			ImmutableAllocator<Node*>::destroy_n(node->Children, node->ChildrenCount);
+			ImmutableAllocator<Node*>::deallocate(node->Children, node->ChildrenCount);
+		}
+		ImmutableAllocator<Node>::ReleaseReferenceCount(node);
+		ImmutableAllocator<Node>::destroy(node);
+		ImmutableAllocator<Node>::deallocate(node, 1);
+	};
+};
\ No newline at end of file
@@ -0,0 +1,282 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	template<class T> class PersistentVector<T>::Leaf : public PersistentNode
+	{
+	public:
+		// Initialization of fields with already initialized elements.
+		Leaf(atomic<size_t>* references, T* values, size_t count) : PersistentNode(references)
+		{
+			Values = values;
+			Count = count;
+		};
+
+		// The elements located in immutable memory.
+		T* Values;
+
+		// Count of the elements.
+		size_t Count;
+	};
+
+	template<class T> class PersistentVector<T>::Branch : public PersistentNode
+	{
+	public:
+		// Initialization of fields with children already referenced for the branch.
+		Branch(atomic<size_t>* references, PersistentNode* const* children, size_t count) : PersistentNode(references)
+		{
+			for (size_t i = 0; i < Width; ++i)
+				Children[i] = (i < count) ? children[i] : nullptr;
+			Count = count;
+		};
+
+		// The nodes of the level below.
+		PersistentNode* Children[Width];
+
+		// Count of the children.
+		size_t Count;
+	};
+
+	template<class T> PersistentVector<T>::PersistentVector() : PersistentVector(nullptr, 0, 0)
+	{
+	};
+
+	template<class T> PersistentVector<T>::PersistentVector(PersistentNode* root, size_t count, size_t shift)
+	{
+		Root = root;
+		Count = count;
+		Shift = shift;
+	};
+
+	template<class T> PersistentVector<T>::PersistentVector(const PersistentVector& other) : PersistentVector(other.Root, other.Count, other.Shift)
+	{
+		if (Root != nullptr)
+			Root->Acquire();
+	};
+
+	template<class T> PersistentVector<T>::PersistentVector(PersistentVector&& other) noexcept : PersistentVector(other.Root, other.Count, other.Shift)
+	{
+		other.Root = nullptr;
+		other.Count = 0;
+		other.Shift = 0;
+	};
+
+	template<class T> PersistentVector<T>& PersistentVector<T>::operator=(PersistentVector other) noexcept
+	{
+		swap(Root, other.Root);
+		swap(Count, other.Count);
+		swap(Shift, other.Shift);
+		return *this;
+	};
+
+	template<class T> PersistentVector<T>::~PersistentVector()
+	{
+		ReleaseNode(Root, Shift);
+	};
+
+	template<class T> size_t PersistentVector<T>::size() const
+	{
+		return Count;
+	};
+
+	template<class T> bool PersistentVector<T>::empty() const
+	{
+		return Count == 0;
+	};
+
+	template<class T> const T& PersistentVector<T>::operator[](size_t index) const
+	{
+		auto node = Root;
+		for (auto level = Shift; level > 0; level -= LevelBits)
+			node = ((Branch*)node)->Children[(index >> level) & (Width - 1)];
+		return ((Leaf*)node)->Values[index & (Width - 1)];
+	};
+
+	template<class T> PersistentVector<T> PersistentVector<T>::push_back(const T& value) const
+	{
+		ImmutableBatch batch;
+		if (Root == nullptr)
+			return PersistentVector(MakeLeaf(nullptr, 1, 0, &value), 1, 0);
+
+		// a full tree grows by a level, the old top becoming the first child of the new one
+		if (Count == (Width << Shift))
+		{
+			PersistentNode* children[] = { Root, nullptr };
+			auto root = MakeBranch(Shift + LevelBits, children, 2, 1, MakePath(Shift, value));
+			return PersistentVector(root, Count + 1, Shift + LevelBits);
+		}
+		return PersistentVector(PushNode(Root, Shift, Count, value), Count + 1, Shift);
+	};
+
+	template<class T> PersistentVector<T> PersistentVector<T>::pop_back() const
+	{
+		constexpr auto vectorIsEmpty = "Vector is empty.";
+		if (Count == 0)
+			throw runtime_error(vectorIsEmpty);
+		if (Count == 1)
+			return PersistentVector();
+
+		ImmutableBatch batch;
+		auto root = PopNode(Root, Shift, Count - 1);
+		auto shift = Shift;
+		// a top with the only child is dropped, so that the tree is never deeper than needed
+		if (shift > 0 && ((Branch*)root)->Count == 1)
+		{
+			auto child = ((Branch*)root)->Children[0];
+			child->Acquire();
+			ReleaseNode(root, shift);
+			root = child;
+			shift -= LevelBits;
+		}
+		return PersistentVector(root, Count - 1, shift);
+	};
+
+	template<class T> PersistentVector<T> PersistentVector<T>::set(size_t index, const T& value) const
+	{
+		constexpr auto indexOutOfRange = "Index is out of range.";
+		if (index >= Count)
+			throw runtime_error(indexOutOfRange);
+
+		ImmutableBatch batch;
+		return PersistentVector(SetNode(Root, Shift, index, value), Count, Shift);
+	};
+
+	template<class T> template<class Node, class... Args> Node* PersistentVector<T>::MakeNode(Args&&... args)
+	{
+		auto node = ImmutableAllocator<Node>::allocate(1);
+		atomic<size_t>* references = nullptr;
+		try
+		{
+			// the counter is kept by the page of the node, so a node costs a single allocation
+			references = ImmutableAllocator<Node>::CreateReferenceCount(node);
+			ImmutableAllocator<Node>::construct(node, references, forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			if (references != nullptr)
+				ImmutableAllocator<Node>::ReleaseReferenceCount(node);
+			ImmutableAllocator<Node>::deallocate(node, 1);
+			throw;
+		}
+		return node;
+	};
+
+	template<class T> PersistentNode* PersistentVector<T>::MakeLeaf(const T* values, size_t count, size_t replacedIndex, const T* replacement)
+	{
+		auto elements = ImmutableAllocator<T>::allocate(count);
+		size_t constructed = 0;
+		try
+		{
+			for (; constructed < count; ++constructed)
+				ImmutableAllocator<T>::construct(elements + constructed, (constructed == replacedIndex) ? *replacement : values[constructed]);
+			return MakeNode<Leaf>(elements, count);
+		}
+		catch (...)
+		{
+			if (constructed != 0)
+				ImmutableAllocator<T>::destroy_n(elements, constructed);
+			ImmutableAllocator<T>::deallocate(elements, count);
+			throw;
+		}
+	};
+
+	template<class T> PersistentNode* PersistentVector<T>::MakeBranch(size_t level, PersistentNode* const* children, size_t count, size_t replacedIndex, PersistentNode* replacement)
+	{
+		PersistentNode* result[Width];
+		for (size_t i = 0; i < count; ++i)
+			result[i] = (i == replacedIndex) ? replacement : children[i];
+
+		PersistentNode* node;
+		try
+		{
+			node = MakeNode<Branch>(result, count);
+		}
+		catch (...)
+		{
+			ReleaseNode(replacement, level - LevelBits);
+			throw;
+		}
+		for (size_t i = 0; i < count; ++i)
+			if (i != replacedIndex)
+				result[i]->Acquire();
+		return node;
+	};
+
+	template<class T> PersistentNode* PersistentVector<T>::MakePath(size_t level, const T& value)
+	{
+		if (level == 0)
+			return MakeLeaf(nullptr, 1, 0, &value);
+		return MakeBranch(level, nullptr, 1, 0, MakePath(level - LevelBits, value));
+	};
+
+	template<class T> PersistentNode* PersistentVector<T>::SetNode(PersistentNode* node, size_t level, size_t index, const T& value)
+	{
+		if (level == 0)
+		{
+			auto leaf = (Leaf*)node;
+			return MakeLeaf(leaf->Values, leaf->Count, index & (Width - 1), &value);
+		}
+		auto branch = (Branch*)node;
+		auto position = (index >> level) & (Width - 1);
+		auto child = SetNode(branch->Children[position], level - LevelBits, index, value);
+		return MakeBranch(level, branch->Children, branch->Count, position, child);
+	};
+
+	template<class T> PersistentNode* PersistentVector<T>::PushNode(PersistentNode* node, size_t level, size_t index, const T& value)
+	{
+		if (level == 0)
+		{
+			auto leaf = (Leaf*)node;
+			return MakeLeaf(leaf->Values, leaf->Count + 1, leaf->Count, &value);
+		}
+		auto branch = (Branch*)node;
+		auto position = (index >> level) & (Width - 1);
+		if (position < branch->Count)
+			return MakeBranch(level, branch->Children, branch->Count, position, PushNode(branch->Children[position], level - LevelBits, index, value));
+		return MakeBranch(level, branch->Children, branch->Count + 1, position, MakePath(level - LevelBits, value));
+	};
+
+	template<class T> PersistentNode* PersistentVector<T>::PopNode(PersistentNode* node, size_t level, size_t index)
+	{
+		if (level == 0)
+		{
+			auto leaf = (Leaf*)node;
+			if (leaf->Count == 1)
+				return nullptr;
+			return MakeLeaf(leaf->Values, leaf->Count - 1, Width, nullptr);
+		}
+		auto branch = (Branch*)node;
+		auto position = (index >> level) & (Width - 1);
+		auto child = PopNode(branch->Children[position], level - LevelBits, index);
+		if (child != nullptr)
+			return MakeBranch(level, branch->Children, branch->Count, position, child);
+		if (position == 0)
+			return nullptr;
+		return MakeBranch(level, branch->Children, branch->Count - 1, Width, nullptr);
+	};
+
+	template<class T> void PersistentVector<T>::ReleaseNode(PersistentNode* node, size_t level)
+	{
+		if (node == nullptr || !node->Release())
+			return;
+
+		if (level == 0)
+		{
+			auto leaf = (Leaf*)node;
+			ImmutableAllocator<T>::destroy_n(leaf->Values, leaf->Count);
+			ImmutableAllocator<T>::deallocate(leaf->Values, leaf->Count);
+			ImmutableAllocator<Leaf>::ReleaseReferenceCount(leaf);
+			ImmutableAllocator<Leaf>::destroy(leaf);
+			ImmutableAllocator<Leaf>::deallocate(leaf, 1);
+			return;
+		}
+		auto branch = (Branch*)node;
+		for (size_t i = 0; i < branch->Count; ++i)
+			ReleaseNode(branch->Children[i], level - LevelBits);
+		ImmutableAllocator<Branch>::ReleaseReferenceCount(branch);
+		ImmutableAllocator<Branch>::destroy(branch);
+		ImmutableAllocator<Branch>::deallocate(branch, 1);
+	};
+};
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../headers/immutable.h"
+
+namespace immutable
+{
+	template<class T> const T* SnapshotPointer<T>::get() const
+	{
+		if (Offset == 0)
+			return nullptr;
+		return (const T*)((const char*)this + Offset);
+	};
+
+	template<class T> const T& SnapshotPointer<T>::operator*() const
+	{
+		return *get();
+	};
+
+	template<class T> const T* SnapshotPointer<T>::operator->() const
+	{
+		return get();
+	};
+
+	template<class T> const T& SnapshotPointer<T>::operator[](size_t index) const
+	{
+		return get()[index];
+	};
+
+	template<class T> SnapshotPointer<T>::operator bool() const
+	{
+		return Offset != 0;
+	};
+};
\ No newline at end of file
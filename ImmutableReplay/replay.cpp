@@ -0,0 +1,378 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <thread>
+
+#ifdef __unix__
+#include <sys/resource.h>
+#endif
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::replay
+{
+	// A plain object standing in for the recorded objects of the same size class.
+	template<size_t Size> class ReplayObject
+	{
+	public:
+		// Contents written on construction, so that the page is touched as the recorded object touched it.
+		char Bytes[Size];
+	};
+
+	// Sizes the recorded objects are rounded up to: the smallest ones, multiples of the word up to 256 bytes, then powers of two up to the page.
+	static constexpr array<size_t, 39> ReplaySizes = []()
+	{
+		array<size_t, 39> result = { 1, 2, 4 };
+		for (size_t i = 0; i < 32; ++i)
+			result[3 + i] = (i + 1) * 8;
+		for (size_t i = 0; i < 4; ++i)
+			result[35 + i] = (size_t)512 << i;
+		return result;
+	}();
+
+	// Allocator calls for objects of a single size class.
+	class ReplayOperations
+	{
+	public:
+		// Allocates memory for the count of objects.
+		void* (*Allocate)(size_t count);
+
+		// Initializes the count of objects.
+		void (*Construct)(void* address, size_t count);
+
+		// Deinitializes the count of objects.
+		void (*Destroy)(void* address, size_t count);
+
+		// Frees memory of the count of objects.
+		void (*Deallocate)(void* address, size_t count);
+	};
+
+	// Makes the calls of the allocator configuration for objects of the size.
+	template<template<class> class Allocator, size_t Size> static ReplayOperations MakeOperations()
+	{
+		using Object = ReplayObject<Size>;
+		using Traits = allocator_traits<Allocator<Object>>;
+		ReplayOperations result;
+		result.Allocate = [](size_t count) -> void*
+		{
+			Allocator<Object> allocator;
+			return Traits::allocate(allocator, count);
+		};
+		result.Construct = [](void* address, size_t count)
+		{
+			Allocator<Object> allocator;
+			// a recorded sequence is initialized with a single call where the allocator has one
+			if constexpr (requires { Allocator<Object>::construct_n((Object*)address, count); })
+				Allocator<Object>::construct_n((Object*)address, count);
+			else
+				for (size_t i = 0; i < count; ++i)
+					Traits::construct(allocator, (Object*)address + i);
+		};
+		result.Destroy = [](void* address, size_t count)
+		{
+			Allocator<Object> allocator;
+			if constexpr (requires { Allocator<Object>::destroy_n((Object*)address, count); })
+				Allocator<Object>::destroy_n((Object*)address, count);
+			else
+				for (size_t i = 0; i < count; ++i)
+					Traits::destroy(allocator, (Object*)address + i);
+		};
+		result.Deallocate = [](void* address, size_t count)
+		{
+			Allocator<Object> allocator;
+			Traits::deallocate(allocator, (Object*)address, count);
+		};
+		return result;
+	};
+
+	// Makes the calls of the allocator configuration for every size class.
+	template<template<class> class Allocator, size_t... Indexes> static vector<ReplayOperations> MakeOperationsTable(index_sequence<Indexes...>)
+	{
+		return { MakeOperations<Allocator, ReplaySizes[Indexes]>()... };
+	};
+
+	// Memory allocated by the replay in place of the recorded one.
+	class ReplayBlock
+	{
+	public:
+		// Address of the memory allocated by the replay.
+		char* Address;
+
+		// Size of a single recorded object.
+		size_t RecordedSize;
+
+		// Index of the size class the objects are replayed with.
+		size_t SizeClass;
+
+		// Count of replayed objects per recorded object (more than one only for objects larger than the largest class).
+		size_t Factor;
+
+		// Count of replayed objects.
+		size_t Count;
+	};
+
+	// Latencies of the calls of a single entry point.
+	class LatencyLog
+	{
+	public:
+		// Durations of every call.
+		vector<uint64_t> Nanoseconds;
+
+		// Prints the percentiles of the durations as a table row.
+		void Report(const char* name)
+		{
+			if (Nanoseconds.empty())
+			{
+				printf("%-12s %12d\n", name, 0);
+				return;
+			}
+			sort(Nanoseconds.begin(), Nanoseconds.end());
+			auto percentile = [&](double fraction) { return Nanoseconds[min(Nanoseconds.size() - 1, (size_t)(fraction * Nanoseconds.size()))]; };
+			printf("%-12s %12zu %10llu %10llu %10llu %10llu %12llu\n", name, Nanoseconds.size(), (unsigned long long)percentile(0.5), (unsigned long long)percentile(0.9), (unsigned long long)percentile(0.99), (unsigned long long)percentile(0.999), (unsigned long long)Nanoseconds.back());
+		};
+	};
+
+	// Reads the resident memory of the process (zero where it is not known).
+	static size_t GetResidentKilobytes()
+	{
+#ifdef __unix__
+		ifstream statm("/proc/self/statm");
+		size_t totalPages = 0;
+		size_t residentPages = 0;
+		statm >> totalPages >> residentPages;
+		return residentPages * (MemoryProtector::GetMemoryPageSize() / 1024);
+#else
+		return 0;
+#endif
+	};
+
+	// Reads the largest resident memory the process ever had (zero where it is not known).
+	static size_t GetPeakResidentKilobytes()
+	{
+#ifdef __unix__
+		rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		return (size_t)usage.ru_maxrss;
+#else
+		return 0;
+#endif
+	};
+
+	// Replays the recorded calls of all threads in their recorded order, each on a thread of its own, so that blocks are owned and freed by the same threads as they were.
+	class Replay
+	{
+	public:
+		// Initialization of fields.
+		Replay(const vector<TraceRecord>& records, const vector<ReplayOperations>& operations) : Records(records), Operations(operations)
+		{
+			NextRecord = 0;
+			LiveBytes = 0;
+			PeakLiveBytes = 0;
+			PeakResidentKilobytes = 0;
+			SkippedCount = 0;
+			FailedCount = 0;
+			// the logs are filled once and emptied, so that their memory is already resident and not counted as the allocator's
+			for (size_t i = 0; i < records.size(); ++i)
+			{
+				ThreadRecords[records[i].Thread].push_back(i);
+				Latencies[(size_t)records[i].Operation].Nanoseconds.push_back(0);
+			}
+			for (auto& latency : Latencies)
+				latency.Nanoseconds.clear();
+			BaseResidentKilobytes = GetResidentKilobytes();
+		};
+
+		// Runs all the calls and waits for them.
+		void Run()
+		{
+			vector<thread> threads;
+			for (auto& [thread, indexes] : ThreadRecords)
+				threads.emplace_back([this, &indexes]() { RunThread(indexes); });
+			for (auto& worker : threads)
+				worker.join();
+			SampleMemory();
+		};
+
+		// Prints the results of the replay.
+		void Report()
+		{
+			printf("%-12s %12s %10s %10s %10s %10s %12s\n", "operation", "calls", "p50 ns", "p90 ns", "p99 ns", "p99.9 ns", "max ns");
+			Latencies[(size_t)TraceOperation::Allocate].Report("allocate");
+			Latencies[(size_t)TraceOperation::Construct].Report("construct");
+			Latencies[(size_t)TraceOperation::Destroy].Report("destroy");
+			Latencies[(size_t)TraceOperation::Deallocate].Report("deallocate");
+			auto usedKilobytes = PeakResidentKilobytes > BaseResidentKilobytes ? PeakResidentKilobytes - BaseResidentKilobytes : 0;
+			auto fragmentation = usedKilobytes != 0 ? 100.0 * (1.0 - min(1.0, (double)PeakLiveBytes / (usedKilobytes * 1024.0))) : 0.0;
+			printf("\npeak rss KiB %zu (%zu before replay), peak live bytes %zu, resident growth at peak KiB %zu, fragmentation %.1f%%\n", GetPeakResidentKilobytes(), BaseResidentKilobytes, PeakLiveBytes, usedKilobytes, fragmentation);
+			printf("skipped calls %zu (memory allocated before the recording), failed calls %zu, blocks left %zu\n", SkippedCount, FailedCount, Blocks.size());
+		};
+
+	private:
+		// Count of calls between two samples of the resident memory.
+		static constexpr size_t SampleInterval = 1024;
+
+		// The recorded calls ordered by their time.
+		const vector<TraceRecord>& Records;
+
+		// Calls of the allocator configuration for every size class.
+		const vector<ReplayOperations>& Operations;
+
+		// Indexes of the records of every recorded thread.
+		map<uint32_t, vector<size_t>> ThreadRecords;
+
+		// Index of the record to be replayed next (threads take their turns by it).
+		atomic<size_t> NextRecord;
+
+		// Blocks allocated by the replay by their recorded addresses.
+		map<uint64_t, ReplayBlock> Blocks;
+
+		// Latencies of every entry point.
+		array<LatencyLog, 4> Latencies;
+
+		// Size of the recorded objects allocated at the moment.
+		size_t LiveBytes;
+
+		// The largest size of the recorded objects allocated at a sample of the resident memory.
+		size_t PeakLiveBytes;
+
+		// Resident memory at the sample with the largest size of allocated objects.
+		size_t PeakResidentKilobytes;
+
+		// Resident memory before the replay.
+		size_t BaseResidentKilobytes;
+
+		// Count of calls for memory the replay does not know.
+		size_t SkippedCount;
+
+		// Count of calls the allocator failed.
+		size_t FailedCount;
+
+		// Replays the calls of a single recorded thread, waiting for the turn of each one.
+		void RunThread(const vector<size_t>& indexes)
+		{
+			for (auto index : indexes)
+			{
+				for (size_t spins = 0; NextRecord.load(memory_order_acquire) != index; ++spins)
+					if (spins > 64)
+						this_thread::yield();
+				try
+				{
+					RunRecord(Records[index]);
+				}
+				catch (...)
+				{
+					++FailedCount;
+				}
+				if (index % SampleInterval == 0)
+					SampleMemory();
+				NextRecord.store(index + 1, memory_order_release);
+			}
+		};
+
+		// Replays a single call, measuring only the call of the allocator.
+		void RunRecord(const TraceRecord& record)
+		{
+			auto& latency = Latencies[(size_t)record.Operation].Nanoseconds;
+			if (record.Operation == TraceOperation::Allocate)
+			{
+				ReplayBlock block;
+				block.RecordedSize = record.Size;
+				block.SizeClass = lower_bound(ReplaySizes.begin(), ReplaySizes.end(), (size_t)record.Size) - ReplaySizes.begin();
+				block.Factor = 1;
+				// objects larger than a page are made of several objects of the largest class
+				if (block.SizeClass == ReplaySizes.size())
+				{
+					block.SizeClass = ReplaySizes.size() - 1;
+					block.Factor = (record.Size + ReplaySizes.back() - 1) / ReplaySizes.back();
+				}
+				block.Count = (size_t)record.Count * block.Factor;
+				auto start = chrono::steady_clock::now();
+				block.Address = (char*)Operations[block.SizeClass].Allocate(block.Count);
+				latency.push_back((uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+				Blocks[record.Address] = block;
+				LiveBytes += (size_t)record.Size * record.Count;
+				return;
+			}
+
+			// objects are constructed and destroyed anywhere within their block, which is found by the address
+			auto it = Blocks.upper_bound(record.Address);
+			if (it == Blocks.begin())
+				return (void)++SkippedCount;
+			--it;
+			auto& block = it->second;
+			auto offset = record.Address - it->first;
+			auto index = offset / block.RecordedSize;
+			if (record.Size != block.RecordedSize || offset % block.RecordedSize != 0 || index + record.Count > block.Count / block.Factor)
+				return (void)++SkippedCount;
+			if (record.Operation == TraceOperation::Deallocate && offset != 0)
+				return (void)++SkippedCount;
+			auto address = block.Address + index * block.Factor * ReplaySizes[block.SizeClass];
+			auto count = (size_t)record.Count * block.Factor;
+			auto& operations = Operations[block.SizeClass];
+			auto start = chrono::steady_clock::now();
+			if (record.Operation == TraceOperation::Construct)
+				operations.Construct(address, count);
+			else if (record.Operation == TraceOperation::Destroy)
+				operations.Destroy(address, count);
+			else
+				operations.Deallocate(address, block.Count);
+			latency.push_back((uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+			if (record.Operation != TraceOperation::Deallocate)
+				return;
+			LiveBytes -= block.RecordedSize * (block.Count / block.Factor);
+			Blocks.erase(it);
+		};
+
+		// Reads the resident memory if more objects are allocated than at any sample before.
+		void SampleMemory()
+		{
+			if (LiveBytes <= PeakLiveBytes)
+				return;
+			PeakLiveBytes = LiveBytes;
+			PeakResidentKilobytes = GetResidentKilobytes();
+		};
+	};
+
+	// The allocator of the standard library, as the baseline for the immutable ones.
+	template<class T> using StandardAllocator = allocator<T>;
+
+	// Makes the calls of the allocator configuration chosen by its name (empty if there is no such configuration).
+	static vector<ReplayOperations> ChooseOperations(const string& name)
+	{
+		auto indexes = make_index_sequence<ReplaySizes.size()>();
+		if (name == "immutable")
+			return MakeOperationsTable<ImmutableAllocator>(indexes);
+		if (name == "soft")
+			return MakeOperationsTable<ImmutableSoftSealedAllocator>(indexes);
+		if (name == "standard")
+			return MakeOperationsTable<StandardAllocator>(indexes);
+		return {};
+	};
+};
+
+int main(int argc, char** argv)
+{
+	using namespace immutable::replay;
+	if (argc < 2)
+	{
+		printf("usage: ImmutableReplay <trace file> [immutable|soft|standard]\n");
+		return 1;
+	}
+	// the dual mapping and huge pages engines are chosen when building, the rest of the configurations here
+	auto name = string(argc > 2 ? argv[2] : "immutable");
+	auto operations = ChooseOperations(name);
+	if (operations.empty())
+	{
+		printf("unknown allocator configuration %s\n", name.c_str());
+		return 1;
+	}
+	auto records = immutable::ImmutableTrace::Load(argv[1]);
+	printf("replaying %zu calls with the %s allocator\n\n", records.size(), name.c_str());
+	Replay replay(records, operations);
+	replay.Run();
+	replay.Report();
+	auto statistics = immutable::ImmutableStatistics::Collect();
+	printf("protect calls %zu, unprotect calls %zu, map calls %zu, unmap calls %zu\n", statistics.ProtectCalls, statistics.UnprotectCalls, statistics.MapCalls, statistics.UnmapCalls);
+	return 0;
+};
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifdef __unix__
+
+#include <signal.h>
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace immutable::tests
+{
+	// Turns a write to protected memory into an exception, as structured exception handling does on Windows (needs -fnon-call-exceptions).
+	static void ThrowAccessViolation(int, siginfo_t*, void*)
+	{
+		constexpr auto accessViolation = "Access violation.";
+		throw runtime_error(accessViolation);
+	};
+
+	// Installs the handler before any test is run.
+	static const bool IsAccessViolationHandled = []()
+	{
+		struct sigaction action = {};
+		action.sa_sigaction = ThrowAccessViolation;
+		// the handler is left by an exception, so the signal must not stay blocked after it
+		action.sa_flags = SA_SIGINFO | SA_NODEFER;
+		return sigaction(SIGSEGV, &action, nullptr) == 0;
+	}();
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include <climits>
+
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	// A tag of the region used only by these tests.
+	class TestRegion
+	{
+	};
+
+	// An allocator for objects confined to a single thread with a region of their own.
+	template<class T> using ConfinedAllocator = BasicImmutableAllocator<T, ImmutableNullLock, PlatformMemoryProtector, ImmutableIsolatedPageSource<TestRegion>>;
+
+	TEST(BasicImmutableAllocatorTests, ConfinedSingleChangeResultIsError)
+	{
+		const int value = INT_MAX;
+		auto object = ConfinedAllocator<int>::allocate(1);
+		ConfinedAllocator<int>::construct(object, value);
+		ASSERT_EQ(*object, value);
+		ASSERT_ANY_THROW((*object) = 0);
+		ASSERT_EQ(*object, value);
+		ConfinedAllocator<int>::destroy(object);
+		ConfinedAllocator<int>::deallocate(object, 1);
+	};
+
+	TEST(BasicImmutableAllocatorTests, ConfinedRegionResultIsSeparate)
+	{
+		auto confined = ConfinedAllocator<int>::allocate(1);
+		auto shared = ImmutableAllocator<int>::allocate(1);
+		ASSERT_ANY_THROW(ImmutableAllocator<int>::construct(confined, 1));
+		ASSERT_ANY_THROW(ConfinedAllocator<int>::construct(shared, 1));
+		ConfinedAllocator<int>::deallocate(confined, 1);
+		ImmutableAllocator<int>::deallocate(shared, 1);
+	};
+
+	TEST(BasicImmutableAllocatorTests, ConfinedContainerResultIsOk)
+	{
+		vector<int, ConfinedAllocator<int>> values;
+		for (int i = 0; i < 1000; ++i) values.push_back(i);
+		for (int i = 0; i < 1000; ++i) ASSERT_EQ(values[i], i);
+		ASSERT_ANY_THROW(values[0] = 1);
+	};
+
+	TEST(BasicImmutableAllocatorTests, DefaultPoliciesResultIsInterchangeable)
+	{
+		auto object = BasicImmutableAllocator<int>::allocate(1);
+		ImmutableAllocator<int>::construct(object, 1);
+		BasicImmutableAllocator<int>::destroy(object);
+		ImmutableAllocator<int>::deallocate(object, 1);
+	};
+};
\ No newline at end of file
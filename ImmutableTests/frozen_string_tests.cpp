@@ -0,0 +1,32 @@
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	TEST(FrozenStringTests, FrozenStringChangeResultIsError)
+	{
+		const string value = "immutable";
+		FrozenString frozen(value);
+		ASSERT_EQ(frozen.size(), value.size());
+		ASSERT_EQ(string_view(frozen), value);
+		ASSERT_EQ(strlen(frozen.c_str()), value.size());
+		ASSERT_ANY_THROW(const_cast<char&>(frozen[0]) = 'I');
+		ASSERT_EQ(frozen[0], 'i');
+	};
+
+	TEST(FrozenStringTests, EmptyFrozenStringResultIsOk)
+	{
+		FrozenString frozen("");
+		ASSERT_TRUE(frozen.empty());
+		ASSERT_STREQ(frozen.c_str(), "");
+	};
+
+	TEST(FrozenStringTests, UnterminatedViewResultIsTerminated)
+	{
+		const string value = "immutable";
+		FrozenString frozen(string_view(value).substr(0, 2));
+		ASSERT_EQ(frozen.size(), 2);
+		ASSERT_STREQ(frozen.c_str(), "im");
+	};
+};
\ No newline at end of file
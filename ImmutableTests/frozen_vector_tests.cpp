@@ -0,0 +1,46 @@
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	TEST(FrozenVectorTests, FrozenVectorFromMutableVectorChangeResultIsError)
+	{
+		const char old_value = 'a';
+		const char new_value = 'z';
+		const int count = 100000;
+		vector<char> chars;
+		for (int i = 0; i < count; ++i) chars.push_back(old_value);
+		FrozenVector<char> frozen(move(chars));
+		ASSERT_EQ(frozen.size(), count);
+		for (int i = 0; i < count; ++i) ASSERT_EQ(frozen[i], old_value);
+		for (int i = 0; i < count; ++i) ASSERT_ANY_THROW(const_cast<char&>(frozen[i]) = new_value);
+		for (int i = 0; i < count; ++i) ASSERT_NE(frozen[i], new_value);
+	};
+
+	TEST(FrozenVectorTests, FrozenVectorCopyResultIsEqual)
+	{
+		FrozenVector<string> original = { "first", "second", "third" };
+		FrozenVector<string> copy = original;
+		ASSERT_NE(copy.data(), original.data());
+		ASSERT_TRUE(equal(copy.begin(), copy.end(), original.begin(), original.end()));
+		span<const string> view = copy;
+		ASSERT_EQ(view.size(), 3);
+		ASSERT_EQ(view[1], "second");
+	};
+
+	TEST(FrozenVectorTests, EmptyFrozenVectorResultIsOk)
+	{
+		vector<int> values;
+		FrozenVector<int> frozen(values.begin(), values.end());
+		ASSERT_TRUE(frozen.empty());
+		ASSERT_EQ(frozen.begin(), frozen.end());
+	};
+
+	TEST(FrozenVectorTests, FrozenVectorOfFrozenStringsResultIsOk)
+	{
+		FrozenVector<FrozenString> frozen = { FrozenString("first"), FrozenString("second") };
+		ASSERT_EQ(frozen.size(), 2);
+		ASSERT_STREQ(frozen[1].c_str(), "second");
+	};
+};
\ No newline at end of file
@@ -1,6 +1,15 @@
+#include <climits>
+#include <latch>
+#include <thread>
+
+#ifdef __unix__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #include "gtest/gtest.h"
 
-#include "..\ImmutableLibrary\headers\immutable.h"
+#include "../ImmutableLibrary/headers/immutable.h"
 
 namespace immutable::tests
 {
@@ -78,4 +87,230 @@ namespace immutable::tests
 		for (int i = 0; i < count; ++i) ASSERT_ANY_THROW(chars[i] = new_value);
 		for (int i = 0; i < count; ++i) ASSERT_NE(chars[i], new_value);
 	};
+
+	TEST(ImmutableAllocatorTests, ImmutableCrossThreadReleaseResultIsOk)
+	{
+		const int value = INT_MAX;
+		const int count = 1000;
+		vector<int*> objects(count);
+		// the producer stays alive while the consumer frees, so that its heap is not handed over and every free is remote
+		latch produced(1);
+		latch consumed(1);
+		ImmutableStatistics pending;
+		ImmutableStatistics reused;
+		int* again = nullptr;
+		thread producer([&]()
+		{
+			for (auto& object : objects)
+			{
+				object = ImmutableAllocator<int>::allocate(1);
+				ImmutableAllocator<int>::construct(object, value);
+			}
+			produced.count_down();
+			consumed.wait();
+			pending = ImmutableStatistics::Collect();
+			again = ImmutableAllocator<int>::allocate(1);
+			reused = ImmutableStatistics::Collect();
+			ImmutableAllocator<int>::deallocate(again, 1);
+		});
+		produced.wait();
+		thread consumer([&]()
+		{
+			for (auto& object : objects)
+			{
+				ASSERT_EQ((*object), value);
+				ASSERT_NO_THROW(ImmutableAllocator<int>::destroy(object));
+				ASSERT_NO_THROW(ImmutableAllocator<int>::deallocate(object, 1));
+			}
+		});
+		consumer.join();
+		consumed.count_down();
+		producer.join();
+		// remote frees wait in the queue of the producer until its next call, which takes them and reuses their slots
+		ASSERT_EQ(reused.LiveBlocks, pending.LiveBlocks - count + 1);
+		ASSERT_NE(find(objects.begin(), objects.end(), again), objects.end());
+	};
+
+	TEST(ImmutableAllocatorTests, ImmutableFreedSlotReuseResultIsOk)
+	{
+		auto first = ImmutableAllocator<int>::allocate(1);
+		auto second = ImmutableAllocator<int>::allocate(1);
+		ImmutableAllocator<int>::deallocate(first, 1);
+		auto third = ImmutableAllocator<int>::allocate(1);
+		ASSERT_EQ(third, first);
+		ImmutableAllocator<int>::deallocate(second, 1);
+		ImmutableAllocator<int>::deallocate(third, 1);
+	};
+
+	TEST(ImmutableAllocatorTests, PlainObjectWithoutUnlockingResultIsOk)
+	{
+		if (!MemoryProtector::HasWritableAlias)
+			GTEST_SKIP();
+		const int value = INT_MAX;
+		auto object = ImmutableAllocator<int>::allocate(1);
+		auto before = ImmutableStatistics::Collect();
+		ImmutableAllocator<int>::construct(object, value);
+		ImmutableAllocator<int>::destroy(object);
+		auto after = ImmutableStatistics::Collect();
+		ASSERT_EQ(after.UnprotectCalls, before.UnprotectCalls);
+		ImmutableAllocator<int>::construct(object, value);
+		ASSERT_EQ((*object), value);
+		ASSERT_ANY_THROW((*object) = 0);
+		ImmutableAllocator<int>::destroy(object);
+		ImmutableAllocator<int>::deallocate(object, 1);
+	};
+
+	// A table of floats aligned for wide vector loads.
+	class alignas(64) WideFloats
+	{
+	public:
+		float Values[16];
+	};
+
+#ifdef __unix__
+	TEST(ImmutableAllocatorTests, ForkedChildReuseResultIsSeparate)
+	{
+		const int value = 7;
+		auto object = ImmutableAllocator<int>::allocate(1);
+		ImmutableAllocator<int>::construct(object, value);
+		auto child = fork();
+		ASSERT_NE(child, -1);
+		if (child == 0)
+		{
+			// the child reads the object, frees it and builds another one in its place, which must never reach the parent
+			if ((*object) != value)
+				_exit(1);
+			ImmutableAllocator<int>::destroy(object);
+			ImmutableAllocator<int>::deallocate(object, 1);
+			auto other = ImmutableAllocator<int>::allocate(1);
+			ImmutableAllocator<int>::construct(other, 0);
+			_exit((*other) == 0 ? 0 : 1);
+		}
+		int status = 0;
+		waitpid(child, &status, 0);
+		ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+		ASSERT_EQ((*object), value);
+		ImmutableAllocator<int>::destroy(object);
+		ImmutableAllocator<int>::deallocate(object, 1);
+	};
+#endif
+
+	TEST(ImmutableAllocatorTests, OverAlignedObjectResultIsAligned)
+	{
+		vector<WideFloats*> objects;
+		for (int i = 0; i < 100; ++i) objects.push_back(ImmutableAllocator<WideFloats>::allocate(1));
+		for (auto object : objects) ASSERT_EQ((size_t)object % alignof(WideFloats), 0);
+		for (auto object : objects) ImmutableAllocator<WideFloats>::deallocate(object, 1);
+	};
+
+	TEST(ImmutableAllocatorTests, CustomAlignmentResultIsAligned)
+	{
+		using Block = array<char, 24>;
+		const size_t alignment = 256;
+		vector<Block*> objects;
+		for (int i = 0; i < 100; ++i) objects.push_back(ImmutableAllocator<Block>::allocate(3, align_val_t(alignment)));
+		for (auto object : objects) ASSERT_EQ((size_t)object % alignment, 0);
+		ImmutableAllocator<Block>::construct_n(objects[0], 3);
+		ImmutableAllocator<Block>::destroy_n(objects[0], 3);
+		for (auto object : objects) ImmutableAllocator<Block>::deallocate(object, 3);
+		ASSERT_ANY_THROW(ImmutableAllocator<Block>::allocate(1, align_val_t(3)));
+	};
+
+	TEST(ImmutableAllocatorTests, CacheLineAllocationResultIsWithinLine)
+	{
+		using Block = array<char, 24>;
+		vector<Block*> objects;
+		for (int i = 0; i < 100; ++i) objects.push_back(ImmutableAllocator<Block>::AllocateInCacheLine(1));
+		for (auto object : objects) ASSERT_LE((size_t)object % 64 + sizeof(Block), 64);
+		for (auto object : objects) ImmutableAllocator<Block>::deallocate(object, 1);
+	};
+
+	TEST(ImmutableAllocatorTests, AllocationAtLeastResultIsWholePages)
+	{
+		const size_t count = 3000;
+		auto result = ImmutableAllocator<int>::allocate_at_least(count);
+		ASSERT_GE(result.count, count);
+		for (size_t i = 0; i < result.count; ++i) ImmutableAllocator<int>::construct(result.ptr + i, (int)i);
+		ASSERT_EQ(result.ptr[result.count - 1], (int)result.count - 1);
+		ImmutableAllocator<int>::destroy_n(result.ptr, result.count);
+		ImmutableAllocator<int>::deallocate(result.ptr, result.count);
+	};
+
+	TEST(ImmutableAllocatorTests, WholePagesReallocationResultKeepsValues)
+	{
+		size_t count = 2048;
+		auto objects = ImmutableAllocator<int>::allocate(count);
+		{
+			ImmutableBatch batch;
+			for (size_t i = 0; i < count; ++i) ImmutableAllocator<int>::construct(objects + i, (int)i);
+			while (count < 1000000)
+			{
+				objects = ImmutableAllocator<int>::Reallocate(objects, count, count * 2);
+				for (size_t i = count; i < count * 2; ++i) ImmutableAllocator<int>::construct(objects + i, (int)i);
+				count *= 2;
+			}
+		}
+		objects = ImmutableAllocator<int>::Reallocate(objects, count, count * 2);
+		ASSERT_ANY_THROW(objects[count] = 1);
+		count *= 2;
+		for (size_t i = 0; i < count / 2; ++i) ASSERT_EQ(objects[i], (int)i);
+		ASSERT_ANY_THROW(objects[0] = 1);
+		ImmutableAllocator<int>::destroy_n(objects, count / 2);
+		ImmutableAllocator<int>::deallocate(objects, count);
+	};
+
+	TEST(ImmutableAllocatorTests, SharedPageReallocationResultKeepsValues)
+	{
+		auto objects = ImmutableAllocator<int>::allocate(2);
+		auto neighbour = ImmutableAllocator<int>::allocate(1);
+		ImmutableAllocator<int>::construct(objects, 1);
+		ImmutableAllocator<int>::construct(objects + 1, 2);
+		auto grown = ImmutableAllocator<int>::Reallocate(objects, 2, 10);
+		ASSERT_EQ(grown[0], 1);
+		ASSERT_EQ(grown[1], 2);
+		ImmutableAllocator<int>::construct(grown + 2, 3);
+		ASSERT_ANY_THROW(ImmutableAllocator<int>::construct(grown, 0));
+		ImmutableAllocator<int>::destroy_n(grown, 3);
+		ImmutableAllocator<int>::deallocate(grown, 10);
+		ImmutableAllocator<int>::deallocate(neighbour, 1);
+	};
+
+	TEST(ImmutableAllocatorTests, CloseSizesResultSharesPages)
+	{
+		// blocks from 17 to 24 bytes fall into two size classes, so they take at most a page for each class instead of a page for each size
+		auto before = ImmutableStatistics::Collect();
+		auto first = ImmutableAllocator<array<char, 17>>::allocate(1);
+		auto second = ImmutableAllocator<array<char, 18>>::allocate(1);
+		auto third = ImmutableAllocator<array<char, 19>>::allocate(1);
+		auto fourth = ImmutableAllocator<array<char, 20>>::allocate(1);
+		auto fifth = ImmutableAllocator<array<char, 21>>::allocate(1);
+		auto sixth = ImmutableAllocator<array<char, 22>>::allocate(1);
+		auto seventh = ImmutableAllocator<array<char, 23>>::allocate(1);
+		auto eighth = ImmutableAllocator<array<char, 24>>::allocate(1);
+		auto after = ImmutableStatistics::Collect();
+		ASSERT_LE(after.LivePages, before.LivePages + 2);
+		ImmutableAllocator<array<char, 17>>::construct(first);
+		ImmutableAllocator<array<char, 17>>::destroy(first);
+		ImmutableAllocator<array<char, 17>>::deallocate(first, 1);
+		ImmutableAllocator<array<char, 18>>::deallocate(second, 1);
+		ImmutableAllocator<array<char, 19>>::deallocate(third, 1);
+		ImmutableAllocator<array<char, 20>>::deallocate(fourth, 1);
+		ImmutableAllocator<array<char, 21>>::deallocate(fifth, 1);
+		ImmutableAllocator<array<char, 22>>::deallocate(sixth, 1);
+		ImmutableAllocator<array<char, 23>>::deallocate(seventh, 1);
+		ImmutableAllocator<array<char, 24>>::deallocate(eighth, 1);
+	};
+
+	TEST(ImmutableAllocatorTests, SizeClassReallocationResultKeepsValue)
+	{
+		using Block = array<char, 18>;
+		auto object = ImmutableAllocator<Block>::allocate(1);
+		ImmutableAllocator<Block>::construct(object, Block{ 'a', 'b' });
+		auto grown = ImmutableAllocator<Block>::Reallocate(object, 1, 3);
+		ASSERT_EQ(grown[0][0], 'a');
+		ASSERT_EQ(grown[0][1], 'b');
+		ImmutableAllocator<Block>::construct(grown + 1);
+		ImmutableAllocator<Block>::destroy_n(grown, 2);
+		ImmutableAllocator<Block>::deallocate(grown, 3);
+	};
 };
\ No newline at end of file
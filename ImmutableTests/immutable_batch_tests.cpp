@@ -0,0 +1,51 @@
+#include <climits>
+
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	TEST(ImmutableBatchTests, BatchContainerChangeAfterCommitResultIsError)
+	{
+		const char old_value = 'a';
+		const char new_value = 'z';
+		const int count = 100000;
+		vector<char, ImmutableAllocator<char>> chars;
+		ImmutableBatch* batch = new ImmutableBatch();
+		for (int i = 0; i < count; ++i) chars.push_back(old_value);
+		ASSERT_NO_THROW(delete batch);
+		for (int i = 0; i < count; ++i) ASSERT_EQ(chars[i], old_value);
+		for (int i = 0; i < count; ++i) ASSERT_ANY_THROW(chars[i] = new_value);
+		for (int i = 0; i < count; ++i) ASSERT_NE(chars[i], new_value);
+	};
+
+	TEST(ImmutableBatchTests, SequenceConstructionChangeResultIsError)
+	{
+		const int old_value = INT_MAX;
+		const int new_value = INT_MIN;
+		const int count = 1000;
+		ASSERT_NE(old_value, new_value);
+		auto objects = ImmutableAllocator<int>::allocate(count);
+		ASSERT_NO_THROW(ImmutableAllocator<int>::construct_n(objects, count, old_value));
+		for (int i = 0; i < count; ++i) ASSERT_EQ(objects[i], old_value);
+		for (int i = 0; i < count; ++i) ASSERT_ANY_THROW(objects[i] = new_value);
+		ASSERT_ANY_THROW(ImmutableAllocator<int>::construct_n(objects, count, new_value));
+		ASSERT_NO_THROW(ImmutableAllocator<int>::destroy_n(objects, count));
+		ASSERT_NO_THROW(ImmutableAllocator<int>::deallocate(objects, count));
+	};
+
+	TEST(ImmutableBatchTests, SequenceConstructionWithErrorResultIsRolledBack)
+	{
+		struct Throwing
+		{
+			Throwing(int& countdown) { if (--countdown == 0) throw runtime_error("Expected error."); };
+		};
+		const int count = 100;
+		int countdown = count / 2;
+		auto objects = ImmutableAllocator<Throwing>::allocate(count);
+		ASSERT_ANY_THROW(ImmutableAllocator<Throwing>::construct_n(objects, count, countdown));
+		ASSERT_ANY_THROW(ImmutableAllocator<Throwing>::destroy_n(objects, 1));
+		ASSERT_NO_THROW(ImmutableAllocator<Throwing>::deallocate(objects, count));
+	};
+};
\ No newline at end of file
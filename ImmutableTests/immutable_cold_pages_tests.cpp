@@ -0,0 +1,98 @@
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	TEST(ImmutableColdPagesTests, ReadAfterCompressionResultIsOk)
+	{
+		vector<int, ImmutableAllocator<int>> values;
+		{
+			ImmutableBatch batch;
+			for (int i = 0; i < 100000; ++i) values.push_back(i % 100);
+		}
+		auto compressedCount = ImmutableColdPages::Compress(chrono::seconds(0));
+		if (MemoryProtector::HasWritableAlias)
+			ASSERT_EQ(compressedCount, 0);
+		else
+			ASSERT_GT(compressedCount, 0);
+		for (int i = 0; i < 100000; ++i) ASSERT_EQ(values[i], i % 100);
+	};
+
+	TEST(ImmutableColdPagesTests, ChangeAfterCompressionResultIsError)
+	{
+		const int value = 7;
+		auto object = ImmutableAllocator<int>::allocate(1);
+		ImmutableAllocator<int>::construct(object, value);
+		ImmutableColdPages::Compress(chrono::seconds(0));
+		ASSERT_ANY_THROW((*object) = 0);
+		ASSERT_EQ(*object, value);
+		ImmutableAllocator<int>::destroy(object);
+		ImmutableAllocator<int>::deallocate(object, 1);
+	};
+
+	TEST(ImmutableColdPagesTests, WriteAfterCompressionResultIsOk)
+	{
+		auto objects = ImmutableAllocator<int>::allocate(2);
+		ImmutableAllocator<int>::construct(objects, 1);
+		ImmutableColdPages::Compress(chrono::seconds(0));
+		ImmutableAllocator<int>::construct(objects + 1, 2);
+		ASSERT_EQ(objects[0], 1);
+		ASSERT_EQ(objects[1], 2);
+		ImmutableAllocator<int>::destroy_n(objects, 2);
+		ImmutableAllocator<int>::deallocate(objects, 2);
+	};
+
+	TEST(ImmutableColdPagesTests, RecentlyTouchedPagesResultIsNotCompressed)
+	{
+		ImmutableColdPages::Compress(chrono::seconds(0));
+		auto object = ImmutableAllocator<int>::allocate(1);
+		ImmutableAllocator<int>::construct(object, 1);
+		ASSERT_EQ(ImmutableColdPages::Compress(chrono::hours(1)), 0);
+		ImmutableAllocator<int>::destroy(object);
+		ImmutableAllocator<int>::deallocate(object, 1);
+	};
+
+	TEST(ImmutableColdPagesTests, ConcurrentReadsResultIsOk)
+	{
+		vector<int, ImmutableAllocator<int>> values;
+		{
+			ImmutableBatch batch;
+			for (int i = 0; i < 100000; ++i) values.push_back(i % 100);
+		}
+		for (int round = 0; round < 10; ++round)
+		{
+			ImmutableColdPages::Compress(chrono::seconds(0));
+			vector<thread> readers;
+			atomic<size_t> mismatchCount = 0;
+			for (int i = 0; i < 4; ++i)
+				readers.emplace_back([&]()
+				{
+					for (int j = 0; j < 100000; ++j)
+						if (values[j] != j % 100) ++mismatchCount;
+				});
+			for (auto& reader : readers) reader.join();
+			ASSERT_EQ(mismatchCount, 0);
+		}
+	};
+
+	TEST(ImmutableColdPagesTests, EmptiedColdPageResultIsReusedEmpty)
+	{
+		// pages are not compressed with the alias, and a page kept for reuse holds what it held before
+		if (MemoryProtector::HasWritableAlias)
+			GTEST_SKIP();
+		const size_t count = ImmutableGlobalPageSource::GetPageSize() / sizeof(int);
+		auto objects = ImmutableAllocator<int>::allocate(count);
+		ImmutableAllocator<int>::construct_n(objects, count, 7);
+		ASSERT_GT(ImmutableColdPages::Compress(chrono::seconds(0)), 0);
+		ImmutableAllocator<int>::destroy_n(objects, count);
+		ImmutableAllocator<int>::deallocate(objects, count);
+		// the page is kept for reuse, but the contents compressed before it was emptied must not come back
+		auto reused = ImmutableAllocator<int>::allocate(count);
+		ASSERT_EQ(reused, objects);
+		ASSERT_EQ(reused[count - 1], 0);
+		ImmutableAllocator<int>::deallocate(reused, count);
+	};
+};
\ No newline at end of file
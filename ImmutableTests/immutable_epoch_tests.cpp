@@ -0,0 +1,68 @@
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	// Objects counting their destructions.
+	class Retirable
+	{
+	public:
+		Retirable(atomic<int>* destroyed) { Destroyed = destroyed; };
+		~Retirable() { ++*Destroyed; };
+		atomic<int>* Destroyed;
+	};
+
+	// Retires an object on the immutable heap that counts its destruction.
+	static void RetireObject(atomic<int>& destroyed)
+	{
+		auto object = ImmutableAllocator<Retirable>::allocate(1);
+		ImmutableAllocator<Retirable>::construct(object, &destroyed);
+		ImmutableEpoch::Retire(object);
+	};
+
+	TEST(ImmutableEpochTests, RetireWithoutReadersResultIsReclaimed)
+	{
+		atomic<int> destroyed = 0;
+		RetireObject(destroyed);
+		for (int i = 0; i < 3; ++i) ImmutableEpoch::Collect();
+		ASSERT_EQ(destroyed, 1);
+	};
+
+	TEST(ImmutableEpochTests, RetireUnderReaderResultIsDeferred)
+	{
+		atomic<int> destroyed = 0;
+		atomic<bool> isReading = false;
+		atomic<bool> isDone = false;
+		thread reader([&]()
+			{
+				const ImmutableReader section;
+				isReading = true;
+				while (!isDone) this_thread::yield();
+			});
+		while (!isReading) this_thread::yield();
+		RetireObject(destroyed);
+		for (int i = 0; i < 3; ++i) ImmutableEpoch::Collect();
+		ASSERT_EQ(destroyed, 0);
+		isDone = true;
+		reader.join();
+		for (int i = 0; i < 3; ++i) ImmutableEpoch::Collect();
+		ASSERT_EQ(destroyed, 1);
+	};
+
+	TEST(ImmutableEpochTests, RetireManyObjectsResultIsCollectedAutomatically)
+	{
+		atomic<int> destroyed = 0;
+		for (int i = 0; i < 1000; ++i)
+		{
+			const ImmutableReader section;
+			RetireObject(destroyed);
+		}
+		ASSERT_GT(destroyed, 0);
+		for (int i = 0; i < 3; ++i) ImmutableEpoch::Collect();
+		ASSERT_EQ(destroyed, 1000);
+	};
+};
\ No newline at end of file
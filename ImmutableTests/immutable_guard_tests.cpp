@@ -1,6 +1,8 @@
+#include <climits>
+
 #include "gtest/gtest.h"
 
-#include "..\ImmutableLibrary\headers\immutable.h"
+#include "../ImmutableLibrary/headers/immutable.h"
 
 namespace immutable::tests
 {
@@ -0,0 +1,59 @@
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	TEST(ImmutableInternPoolTests, InternEqualValuesResultIsSameInstance)
+	{
+		ImmutableInternPool<int> pool;
+		auto first = pool.Intern(42);
+		auto second = pool.Intern(42);
+		auto third = pool.Intern(7);
+		ASSERT_TRUE(first == second);
+		ASSERT_FALSE(first == third);
+		ASSERT_EQ(first.get(), second.get());
+		ASSERT_EQ(*first, 42);
+		ASSERT_EQ(first.hash(), hash<int>()(42));
+		ASSERT_EQ(pool.size(), 2);
+		ASSERT_FALSE(Interned<int>());
+	};
+
+	TEST(ImmutableInternPoolTests, InternStringsResultIsDeduplicated)
+	{
+		ImmutableStringPool pool;
+		auto first = pool.Intern(string_view("repeated key"));
+		auto second = pool.Intern(string_view(string("repeated ") + "key"));
+		ASSERT_TRUE(first == second);
+		ASSERT_STREQ(first->c_str(), "repeated key");
+		ASSERT_EQ(pool.size(), 1);
+	};
+
+	TEST(ImmutableInternPoolTests, InternedValueChangeResultIsError)
+	{
+		ImmutableInternPool<int> pool;
+		auto value = pool.Intern(1);
+		ASSERT_ANY_THROW(const_cast<int&>(*value) = 2);
+		ASSERT_EQ(*value, 1);
+	};
+
+	TEST(ImmutableInternPoolTests, InternFromManyThreadsResultIsSameInstance)
+	{
+		const int count = 1000;
+		const int threadCount = 4;
+		ImmutableInternPool<int> pool;
+		vector<vector<Interned<int>>> results(threadCount);
+		vector<thread> threads;
+		for (int t = 0; t < threadCount; ++t)
+			threads.emplace_back([&pool, &results, t]()
+				{
+					for (int i = 0; i < count; ++i) results[t].push_back(pool.Intern(i));
+				});
+		for (auto& worker : threads) worker.join();
+		ASSERT_EQ(pool.size(), count);
+		for (int t = 1; t < threadCount; ++t)
+			for (int i = 0; i < count; ++i) ASSERT_TRUE(results[t][i] == results[0][i]);
+	};
+};
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include <map>
+
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	TEST(ImmutableMemoryResourceTests, BuildBeforeSealResultIsOk)
+	{
+		ImmutableMemoryResource resource;
+		pmr::vector<int> values(&resource);
+		for (int i = 0; i < 10000; ++i) values.push_back(i);
+		values[0] = 1;
+		ASSERT_EQ(values[0], 1);
+		ASSERT_EQ(values[9999], 9999);
+	};
+
+	TEST(ImmutableMemoryResourceTests, ChangeAfterSealResultIsError)
+	{
+		ImmutableMemoryResource resource;
+		auto values = new pmr::vector<int>(&resource);
+		for (int i = 0; i < 10000; ++i) values->push_back(i);
+		resource.Seal();
+		ASSERT_TRUE(resource.IsSealed());
+		ASSERT_EQ((*values)[9999], 9999);
+		ASSERT_ANY_THROW((*values)[0] = 1);
+		ASSERT_EQ((*values)[0], 0);
+		// the vector would release its memory into the sealed resource, so it is left to the resource
+		::operator delete(values);
+	};
+
+	TEST(ImmutableMemoryResourceTests, NestedContainersAfterSealResultIsError)
+	{
+		ImmutableMemoryResource resource;
+		pmr::map<pmr::string, pmr::vector<pmr::string>> values(&resource);
+		for (int i = 0; i < 100; ++i)
+			values[pmr::string("key that does not fit into a short string " + to_string(i), &resource)].emplace_back("value that does not fit into a short string");
+		resource.Seal();
+		auto& value = values.begin()->second.front();
+		ASSERT_EQ(value, "value that does not fit into a short string");
+		ASSERT_ANY_THROW(value[0] = 'V');
+		ASSERT_ANY_THROW(values.begin()->second.emplace_back("value"));
+	};
+
+	TEST(ImmutableMemoryResourceTests, AllocationAfterSealResultIsError)
+	{
+		ImmutableMemoryResource resource;
+		pmr::vector<int> values(&resource);
+		values.push_back(1);
+		resource.Seal();
+		pmr::vector<int> other(&resource);
+		ASSERT_ANY_THROW(other.push_back(1));
+	};
+
+	TEST(ImmutableMemoryResourceTests, OverAlignedAllocationResultIsAligned)
+	{
+		ImmutableMemoryResource resource;
+		for (size_t alignment = 1; alignment <= 8192; alignment *= 2)
+		{
+			auto memory = resource.allocate(3, alignment);
+			ASSERT_EQ((size_t)memory % alignment, 0);
+		}
+	};
+};
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	TEST(ImmutablePoolTests, FreedPageReuseResultIsOk)
+	{
+		auto first = ImmutableAllocator<char>::allocate(3000);
+		ImmutableAllocator<char>::deallocate(first, 3000);
+		auto before = ImmutableStatistics::Collect();
+		ASSERT_GT(before.RetainedPages, 0);
+		auto second = ImmutableAllocator<char>::allocate(3000);
+		auto after = ImmutableStatistics::Collect();
+		ASSERT_EQ(second, first);
+		ASSERT_EQ(after.MapCalls, before.MapCalls);
+		ASSERT_EQ(after.RetainedPages, before.RetainedPages - 1);
+		ImmutableAllocator<char>::deallocate(second, 3000);
+	};
+
+	TEST(ImmutablePoolTests, ReservedPagesUseResultIsOk)
+	{
+		const int value = 1;
+		ImmutablePool::Reserve(1);
+		auto before = ImmutableStatistics::Collect();
+		ImmutableGuard<long double> guard(value);
+		auto after = ImmutableStatistics::Collect();
+		ASSERT_EQ(*(guard.WrappedObject), value);
+		ASSERT_EQ(after.MapCalls, before.MapCalls);
+	};
+
+	TEST(ImmutablePoolTests, ReservationOverLimitResultIsCapped)
+	{
+		auto pageSize = ImmutableGlobalPageSource::GetPageSize();
+		ImmutablePool::SetRetainedSizeLimit(0);
+		auto before = ImmutableStatistics::Collect();
+		ImmutablePool::Reserve(4 * pageSize);
+		auto after = ImmutableStatistics::Collect();
+		ImmutablePool::SetRetainedSizeLimit((size_t)4 << 20);
+		ASSERT_EQ(after.RetainedPages, before.RetainedPages);
+		ASSERT_EQ(after.MapCalls, before.MapCalls);
+	};
+
+	TEST(ImmutablePoolTests, TrimmedPageChangeResultIsError)
+	{
+		const int old_value = 1;
+		const int new_value = 2;
+		auto first = ImmutableAllocator<short>::allocate(1);
+		ImmutableAllocator<short>::deallocate(first, 1);
+		ImmutablePool::Trim();
+		ImmutableGuard<short> guard(old_value);
+		ASSERT_EQ(*(guard.WrappedObject), old_value);
+		ASSERT_ANY_THROW(*(guard.WrappedObject) = new_value);
+	};
+};
\ No newline at end of file
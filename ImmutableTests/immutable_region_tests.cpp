@@ -0,0 +1,142 @@
+#include <climits>
+
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	// An object counting the calls of its destructor.
+	class CountedObject
+	{
+	public:
+		// The counter is kept outside, since the object itself is sealed.
+		CountedObject(size_t* destroyedCount) : DestroyedCount(destroyedCount) {};
+
+		// Counts the call.
+		~CountedObject() { ++(*DestroyedCount); };
+
+		// The counter of calls of the destructor.
+		size_t* DestroyedCount;
+	};
+
+	// An object that creates another object of the region while being constructed.
+	class OuterObject
+	{
+	public:
+		// Creates the inner object in the same region.
+		OuterObject(ImmutableRegion& region, int value) : Inner(region.Create<int>(value)), Value(value) {};
+
+		// The inner object.
+		int* Inner;
+
+		// The value of the object itself.
+		int Value;
+	};
+
+	TEST(ImmutableRegionTests, SingleChangeResultIsError)
+	{
+		ImmutableRegion region;
+		const int value = INT_MAX;
+		auto object = region.Create<int>(value);
+		ASSERT_EQ(*object, value);
+		ASSERT_ANY_THROW((*object) = 0);
+		ASSERT_EQ(*object, value);
+	};
+
+	TEST(ImmutableRegionTests, ManyObjectsResultIsOk)
+	{
+		ImmutableRegion region;
+		vector<int*> objects;
+		for (int i = 0; i < 100000; ++i) objects.push_back(region.Create<int>(i));
+		for (int i = 0; i < 100000; ++i) ASSERT_EQ(*objects[i], i);
+		ASSERT_EQ(region.size(), 100000 * sizeof(int));
+		ASSERT_ANY_THROW((*objects[50000]) = 0);
+	};
+
+	TEST(ImmutableRegionTests, ArrayResultIsOk)
+	{
+		ImmutableRegion region;
+		auto objects = region.CreateArray<string>(100, "value that does not fit into a short string");
+		for (int i = 0; i < 100; ++i) ASSERT_EQ(objects[i], "value that does not fit into a short string");
+		ASSERT_ANY_THROW(objects[0] = "");
+	};
+
+	TEST(ImmutableRegionTests, ReleaseResultCallsDestructors)
+	{
+		size_t destroyedCount = 0;
+		{
+			ImmutableRegion region;
+			for (int i = 0; i < 1000; ++i) region.Create<CountedObject>(&destroyedCount);
+			region.CreateArray<CountedObject>(10, &destroyedCount);
+			region.Create<int>(1);
+			ASSERT_EQ(destroyedCount, 0);
+		}
+		ASSERT_EQ(destroyedCount, 1010);
+	};
+
+	TEST(ImmutableRegionTests, NestedCreationResultIsSealed)
+	{
+		ImmutableRegion region;
+		auto object = region.Create<OuterObject>(region, 7);
+		ASSERT_EQ(*object->Inner, 7);
+		ASSERT_EQ(object->Value, 7);
+		ASSERT_ANY_THROW((*object->Inner) = 0);
+		ASSERT_ANY_THROW(object->Value = 0);
+	};
+
+	TEST(ImmutableRegionTests, ReuseAfterReleaseResultIsOk)
+	{
+		ImmutableRegion region;
+		region.Create<int>(1);
+		region.Release();
+		ASSERT_EQ(region.size(), 0);
+		auto object = region.Create<int>(2);
+		ASSERT_EQ(*object, 2);
+	};
+	TEST(ImmutableRegionTests, BatchCreationResultIsSealedOnCommit)
+	{
+		ImmutableRegion region;
+		vector<int*> objects;
+		auto before = ImmutableStatistics::Collect();
+		{
+			ImmutableBatch batch;
+			for (int i = 0; i < 100000; ++i) objects.push_back(region.Create<int>(i));
+			objects.push_back(region.Create<OuterObject>(region, 7)->Inner);
+		}
+		auto after = ImmutableStatistics::Collect();
+		ASSERT_LT((after.ProtectCalls + after.UnprotectCalls) - (before.ProtectCalls + before.UnprotectCalls), 100);
+		for (int i = 0; i < 100000; ++i) ASSERT_EQ(*objects[i], i);
+		ASSERT_ANY_THROW((*objects[0]) = 0);
+		ASSERT_ANY_THROW((*objects[100000]) = 0);
+	};
+
+	TEST(ImmutableRegionTests, ReleaseInBatchResultIsOk)
+	{
+		ImmutableBatch batch;
+		{
+			ImmutableRegion region;
+			region.Create<int>(1);
+		}
+		ImmutableRegion region;
+		auto object = region.Create<int>(2);
+		batch.Commit();
+		ASSERT_EQ(*object, 2);
+		ASSERT_ANY_THROW((*object) = 0);
+	};
+
+	TEST(ImmutableRegionTests, CreationCountsResultTakesNoLocks)
+	{
+		ImmutableRegion region;
+		region.Create<int>(0);
+		auto before = ImmutableStatistics::Collect();
+		for (int i = 0; i < 100; ++i) region.Create<int>(i);
+		auto after = ImmutableStatistics::Collect();
+		ASSERT_EQ(after.LockAcquisitions, before.LockAcquisitions);
+		if (!MemoryProtector::HasWritableAlias)
+		{
+			ASSERT_EQ(after.UnprotectCalls, before.UnprotectCalls + 100);
+			ASSERT_EQ(after.ProtectCalls, before.ProtectCalls + 100);
+		}
+	};
+};
\ No newline at end of file
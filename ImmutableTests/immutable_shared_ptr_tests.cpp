@@ -0,0 +1,79 @@
+#include <climits>
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	// Objects counting their destructions.
+	class Counted
+	{
+	public:
+		Counted(int value, atomic<int>* destroyed) { Value = value; Destroyed = destroyed; };
+		~Counted() { ++*Destroyed; };
+		int Value;
+		atomic<int>* Destroyed;
+	};
+
+	TEST(ImmutableSharedPtrTests, SharedPointerCopiesResultIsSingleDestruction)
+	{
+		atomic<int> destroyed = 0;
+		{
+			auto first = MakeImmutableShared<Counted>(42, &destroyed);
+			ASSERT_EQ(first.use_count(), 1);
+			{
+				auto second = first;
+				ImmutableSharedPtr<Counted> third;
+				third = second;
+				ASSERT_EQ(first.use_count(), 3);
+				ASSERT_EQ(third->Value, 42);
+				ASSERT_EQ(third.get(), first.get());
+			}
+			ASSERT_EQ(first.use_count(), 1);
+			ASSERT_EQ(destroyed, 0);
+		}
+		ASSERT_EQ(destroyed, 1);
+	};
+
+	TEST(ImmutableSharedPtrTests, SharedPointerChangeResultIsError)
+	{
+		auto pointer = MakeImmutableShared<int>(INT_MAX);
+		ASSERT_ANY_THROW(const_cast<int&>(*pointer) = 0);
+		ASSERT_EQ(*pointer, INT_MAX);
+		ASSERT_FALSE(ImmutableSharedPtr<int>());
+	};
+
+	TEST(ImmutableSharedPtrTests, SharedPointerReleaseOnAnotherThreadResultIsOk)
+	{
+		atomic<int> destroyed = 0;
+		vector<ImmutableSharedPtr<Counted>> pointers;
+		for (int i = 0; i < 1000; ++i) pointers.push_back(MakeImmutableShared<Counted>(i, &destroyed));
+		auto copies = pointers;
+		thread releaser([&pointers]() { pointers.clear(); });
+		releaser.join();
+		ASSERT_EQ(destroyed, 0);
+		for (int i = 0; i < 1000; ++i) ASSERT_EQ(copies[i]->Value, i);
+		copies.clear();
+		ASSERT_EQ(destroyed, 1000);
+	};
+
+	TEST(ImmutableSharedPtrTests, SlotReuseAfterReleaseResultIsOk)
+	{
+		atomic<int> destroyed = 0;
+		vector<ImmutableSharedPtr<Counted>> pointers;
+		for (int i = 0; i < 1000; ++i) pointers.push_back(MakeImmutableShared<Counted>(i, &destroyed));
+		// the freed slots get new objects with counters of their own, while the counters of the others stay in place
+		for (int i = 0; i < 1000; i += 2) pointers[i] = MakeImmutableShared<Counted>(-i, &destroyed);
+		ASSERT_EQ(destroyed, 500);
+		for (int i = 0; i < 1000; ++i)
+		{
+			ASSERT_EQ(pointers[i]->Value, (i % 2 == 0) ? -i : i);
+			ASSERT_EQ(pointers[i].use_count(), 1);
+		}
+		pointers.clear();
+		ASSERT_EQ(destroyed, 1500);
+	};
+};
\ No newline at end of file
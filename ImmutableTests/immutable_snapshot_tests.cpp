@@ -0,0 +1,121 @@
+#ifdef __linux__
+#include <sys/wait.h>
+#endif
+
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	class SnapshotRoot
+	{
+	public:
+		size_t Count;
+		SnapshotPointer<int> Values;
+	};
+
+	static ImmutableSnapshotBuilder MakeSnapshot(size_t& valuesOffset)
+	{
+		const int values[] = { 1, 2, 3, 4, 5 };
+		ImmutableSnapshotBuilder builder;
+		valuesOffset = builder.Append(values, size(values));
+		auto rootOffset = builder.Append(SnapshotRoot{ size(values), SnapshotPointer<int>() });
+		builder.Link<int>(rootOffset + offsetof(SnapshotRoot, Values), valuesOffset);
+		builder.SetRoot(rootOffset);
+		return builder;
+	};
+
+	static size_t BuildSnapshot(const string& path)
+	{
+		size_t valuesOffset;
+		MakeSnapshot(valuesOffset).Save(path);
+		return valuesOffset;
+	};
+
+	TEST(ImmutableSnapshotTests, ImmutableSnapshotReadResultIsOk)
+	{
+		const string path = "immutable_snapshot_read.bin";
+		auto valuesOffset = BuildSnapshot(path);
+		{
+			ImmutableSnapshot snapshot(path);
+			auto root = snapshot.Root<SnapshotRoot>();
+			ASSERT_EQ(root->Count, 5);
+			for (size_t i = 0; i < root->Count; ++i)
+				ASSERT_EQ(root->Values[i], i + 1);
+			ASSERT_EQ(root->Values.get(), snapshot.View<int>(valuesOffset, root->Count));
+			ASSERT_ANY_THROW(snapshot.View<int>(snapshot.size(), 1));
+		}
+		remove(path.c_str());
+	};
+
+	TEST(ImmutableSnapshotTests, ImmutableSnapshotChangeResultIsError)
+	{
+		const string path = "immutable_snapshot_change.bin";
+		BuildSnapshot(path);
+		{
+			ImmutableSnapshot snapshot(path);
+			auto root = snapshot.Root<SnapshotRoot>();
+			ASSERT_ANY_THROW(const_cast<int&>(root->Values[0]) = 0);
+			ASSERT_EQ(root->Values[0], 1);
+		}
+		remove(path.c_str());
+	};
+
+	TEST(ImmutableSnapshotTests, CorruptedSnapshotResultIsError)
+	{
+		const string path = "immutable_snapshot_corrupted.bin";
+		{
+			ofstream file(path, ios::binary | ios::trunc);
+			file << "definitely not a snapshot of immutable objects";
+		}
+		ASSERT_ANY_THROW(ImmutableSnapshot snapshot(path));
+		remove(path.c_str());
+	};
+
+#ifdef __linux__
+	TEST(ImmutableSnapshotTests, SharedSnapshotChangeResultIsError)
+	{
+		size_t valuesOffset;
+		auto sharedMemory = MakeSnapshot(valuesOffset).Share();
+		const char value = 0;
+		ASSERT_EQ(write(sharedMemory, &value, sizeof(value)), -1);
+		{
+			ImmutableSnapshot snapshot(sharedMemory);
+			auto root = snapshot.Root<SnapshotRoot>();
+			ASSERT_EQ(root->Values[4], 5);
+			ASSERT_ANY_THROW(const_cast<int&>(root->Values[0]) = 0);
+		}
+		close(sharedMemory);
+	};
+
+	TEST(ImmutableSnapshotTests, SharedSnapshotInChildProcessResultIsOk)
+	{
+		int sockets[2];
+		ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+		auto child = fork();
+		ASSERT_NE(child, -1);
+		if (child == 0)
+		{
+			// the child process only reads the snapshot passed to it and reports the sum of the values
+			auto sharedMemory = ImmutableSnapshot::ReceiveSharedMemory(sockets[1]);
+			ImmutableSnapshot snapshot(sharedMemory);
+			auto root = snapshot.Root<SnapshotRoot>();
+			int sum = 0;
+			for (size_t i = 0; i < root->Count; ++i)
+				sum += root->Values[i];
+			_exit(sum);
+		}
+		size_t valuesOffset;
+		auto sharedMemory = MakeSnapshot(valuesOffset).Share();
+		ImmutableSnapshot::SendSharedMemory(sockets[0], sharedMemory);
+		close(sharedMemory);
+		int status = 0;
+		waitpid(child, &status, 0);
+		close(sockets[0]);
+		close(sockets[1]);
+		ASSERT_TRUE(WIFEXITED(status));
+		ASSERT_EQ(WEXITSTATUS(status), 15);
+	};
+#endif
+};
\ No newline at end of file
@@ -0,0 +1,53 @@
+#include <climits>
+
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	TEST(ImmutableSoftSealedAllocatorTests, SingleValueResultIsOk)
+	{
+		const int value = INT_MAX;
+		auto object = ImmutableSoftSealedAllocator<int>::allocate(1);
+		ImmutableSoftSealedAllocator<int>::construct(object, value);
+		ASSERT_EQ(*object, value);
+		ASSERT_EQ(ImmutableSoftSealedAllocator<int>::VerifySealedPages(), 0);
+		ImmutableSoftSealedAllocator<int>::destroy(object);
+		ImmutableSoftSealedAllocator<int>::deallocate(object, 1);
+	};
+
+	TEST(ImmutableSoftSealedAllocatorTests, SingleChangeResultIsFound)
+	{
+		const int value = INT_MAX;
+		auto object = ImmutableSoftSealedAllocator<int>::allocate(1);
+		auto neighbour = ImmutableSoftSealedAllocator<int>::allocate(1);
+		ImmutableSoftSealedAllocator<int>::construct(object, value);
+		// the page stays writable, so the write does not fault
+		(*object) = 0;
+		ASSERT_EQ(ImmutableSoftSealedAllocator<int>::VerifySealedPages(), 1);
+		ASSERT_ANY_THROW(ImmutableSoftSealedAllocator<int>::construct(neighbour, value));
+		(*object) = value;
+		ASSERT_EQ(ImmutableSoftSealedAllocator<int>::VerifySealedPages(), 0);
+		ImmutableSoftSealedAllocator<int>::destroy(object);
+		ImmutableSoftSealedAllocator<int>::deallocate(object, 1);
+		ImmutableSoftSealedAllocator<int>::deallocate(neighbour, 1);
+	};
+
+	TEST(ImmutableSoftSealedAllocatorTests, ContainerResultIsOk)
+	{
+		vector<int, ImmutableSoftSealedAllocator<int>> values;
+		for (int i = 0; i < 1000; ++i) values.push_back(i);
+		for (int i = 0; i < 1000; ++i) ASSERT_EQ(values[i], i);
+		ASSERT_EQ(ImmutableSoftSealedAllocator<int>::VerifySealedPages(), 0);
+	};
+
+	TEST(ImmutableSoftSealedAllocatorTests, HardwareSealedResultIsNotChecked)
+	{
+		auto object = ImmutableAllocator<int>::allocate(1);
+		ImmutableAllocator<int>::construct(object, 1);
+		ASSERT_EQ(ImmutableAllocator<int>::VerifySealedPages(), 0);
+		ImmutableAllocator<int>::destroy(object);
+		ImmutableAllocator<int>::deallocate(object, 1);
+	};
+};
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	// Objects that are not plain are always written by opening their page.
+	class NotPlain
+	{
+	public:
+		NotPlain(int value) { Value = value; };
+		~NotPlain() {};
+		int Value;
+	};
+
+	static size_t LockedPagesCount = 0;
+
+	static void CountLockedPages(ImmutableEvent event, void*, size_t)
+	{
+		if (event == ImmutableEvent::PageLocked)
+			++LockedPagesCount;
+	};
+
+	TEST(ImmutableStatisticsTests, LiveBlocksCountResultIsOk)
+	{
+		const int count = 10;
+		auto before = ImmutableStatistics::Collect();
+		auto objects = ImmutableAllocator<double>::allocate(count);
+		auto during = ImmutableStatistics::Collect();
+		ASSERT_EQ(during.LiveBlocks, before.LiveBlocks + count);
+		ASSERT_EQ(during.LiveBytes, before.LiveBytes + count * sizeof(double));
+		ASSERT_EQ(during.AllocationSizeHistogram[bit_width(count * sizeof(double))], before.AllocationSizeHistogram[bit_width(count * sizeof(double))] + 1);
+		ImmutableAllocator<double>::deallocate(objects, count);
+		auto after = ImmutableStatistics::Collect();
+		ASSERT_EQ(after.LiveBlocks, before.LiveBlocks);
+		ASSERT_EQ(after.LiveBytes, before.LiveBytes);
+	};
+
+	TEST(ImmutableStatisticsTests, ProtectCallsCountResultIsOk)
+	{
+		// plain objects are written through the alias without opening their page, which is counted by its own test
+		if (MemoryProtector::HasWritableAlias)
+			GTEST_SKIP();
+		auto object = ImmutableAllocator<int>::allocate(1);
+		auto before = ImmutableStatistics::Collect();
+		ImmutableAllocator<int>::construct(object, 1);
+		auto after = ImmutableStatistics::Collect();
+		ASSERT_EQ(after.UnprotectCalls, before.UnprotectCalls + 1);
+		ASSERT_EQ(after.ProtectCalls, before.ProtectCalls + 1);
+		ImmutableAllocator<int>::destroy(object);
+		ImmutableAllocator<int>::deallocate(object, 1);
+	};
+
+	TEST(ImmutableStatisticsTests, EventHookCallResultIsOk)
+	{
+		if (MemoryProtector::HasWritableAlias)
+			GTEST_SKIP();
+		LockedPagesCount = 0;
+		ImmutableStatistics::SetEventHook(CountLockedPages);
+		ImmutableGuard<int> guard(1);
+		ImmutableStatistics::SetEventHook(nullptr);
+		ASSERT_EQ(LockedPagesCount, 1);
+	};
+
+	TEST(ImmutableStatisticsTests, AliasProtectCallsCountResultIsOk)
+	{
+		if (!MemoryProtector::HasWritableAlias)
+			GTEST_SKIP();
+		auto plain = ImmutableAllocator<int>::allocate(1);
+		auto object = ImmutableAllocator<NotPlain>::allocate(1);
+		auto before = ImmutableStatistics::Collect();
+		ImmutableAllocator<int>::construct(plain, 1);
+		auto during = ImmutableStatistics::Collect();
+		ASSERT_EQ(during.UnprotectCalls, before.UnprotectCalls);
+		ASSERT_EQ(during.ProtectCalls, before.ProtectCalls);
+		ImmutableAllocator<NotPlain>::construct(object, 1);
+		auto after = ImmutableStatistics::Collect();
+		ASSERT_EQ(after.UnprotectCalls, during.UnprotectCalls + 1);
+		ASSERT_EQ(after.ProtectCalls, during.ProtectCalls + 1);
+		ImmutableAllocator<NotPlain>::destroy(object);
+		ImmutableAllocator<NotPlain>::deallocate(object, 1);
+		ImmutableAllocator<int>::destroy(plain);
+		ImmutableAllocator<int>::deallocate(plain, 1);
+	};
+
+	TEST(ImmutableStatisticsTests, AliasEventHookCallResultIsOk)
+	{
+		if (!MemoryProtector::HasWritableAlias)
+			GTEST_SKIP();
+		LockedPagesCount = 0;
+		ImmutableStatistics::SetEventHook(CountLockedPages);
+		ImmutableGuard<int> plain(1);
+		ImmutableGuard<NotPlain> guard(1);
+		ImmutableStatistics::SetEventHook(nullptr);
+		ASSERT_EQ(LockedPagesCount, 1);
+	};
+
+	TEST(ImmutableStatisticsTests, IsolatedHeapsCountResultIsOk)
+	{
+		auto before = ImmutableStatistics::Collect();
+		auto confined = ImmutableConfinedAllocator<NotPlain>::allocate(2);
+		auto softSealed = ImmutableSoftSealedAllocator<double>::allocate(3);
+		ImmutableConfinedAllocator<NotPlain>::construct(confined, 1);
+		auto during = ImmutableStatistics::Collect();
+		ASSERT_EQ(during.LiveBlocks, before.LiveBlocks + 5);
+		ASSERT_EQ(during.LiveBytes, before.LiveBytes + 2 * sizeof(NotPlain) + 3 * sizeof(double));
+		ASSERT_GT(during.UnprotectCalls, before.UnprotectCalls);
+		ImmutableConfinedAllocator<NotPlain>::destroy(confined);
+		ImmutableConfinedAllocator<NotPlain>::deallocate(confined, 2);
+		ImmutableSoftSealedAllocator<double>::deallocate(softSealed, 3);
+		auto after = ImmutableStatistics::Collect();
+		ASSERT_EQ(after.LiveBlocks, before.LiveBlocks);
+	};
+
+	TEST(ImmutableStatisticsTests, IsolatedHeapReuseResultIsOk)
+	{
+		auto churn = []() { ImmutableConfinedAllocator<int>::deallocate(ImmutableConfinedAllocator<int>::allocate(1), 1); };
+		thread(churn).join();
+		auto heapsCount = MemoryHeap::GetAllHeaps().size();
+		thread(churn).join();
+		ASSERT_EQ(MemoryHeap::GetAllHeaps().size(), heapsCount);
+	};
+};
\ No newline at end of file
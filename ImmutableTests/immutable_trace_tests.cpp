@@ -0,0 +1,102 @@
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	TEST(ImmutableTraceTests, RecordedCallsResultIsOk)
+	{
+		const string path = "immutable_trace_calls.bin";
+		ImmutableTrace::Start(path);
+		auto objects = ImmutableAllocator<double>::allocate(3);
+		ImmutableAllocator<double>::construct(objects, 1.0);
+		ImmutableAllocator<double>::destroy(objects);
+		ImmutableAllocator<double>::deallocate(objects, 3);
+		ImmutableTrace::Stop();
+		auto records = ImmutableTrace::Load(path);
+		ASSERT_EQ(records.size(), 4);
+		ASSERT_EQ(records[0].Operation, TraceOperation::Allocate);
+		ASSERT_EQ(records[1].Operation, TraceOperation::Construct);
+		ASSERT_EQ(records[2].Operation, TraceOperation::Destroy);
+		ASSERT_EQ(records[3].Operation, TraceOperation::Deallocate);
+		for (auto& record : records)
+		{
+			ASSERT_EQ(record.Address, (uint64_t)(uintptr_t)objects);
+			ASSERT_EQ(record.Size, sizeof(double));
+			ASSERT_EQ(record.Thread, records[0].Thread);
+		}
+		ASSERT_EQ(records[0].Count, 3);
+		ASSERT_EQ(records[1].Count, 1);
+		ASSERT_EQ(records[3].Count, 3);
+		ASSERT_LE(records[0].Nanoseconds, records[3].Nanoseconds);
+		remove(path.c_str());
+	};
+
+	TEST(ImmutableTraceTests, CallsOfSeveralThreadsResultIsOk)
+	{
+		const string path = "immutable_trace_threads.bin";
+		const size_t count = 10000;
+		ImmutableTrace::Start(path);
+		auto churn = [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+				ImmutableAllocator<int>::deallocate(ImmutableAllocator<int>::allocate(1), 1);
+		};
+		thread first(churn);
+		thread second(churn);
+		first.join();
+		second.join();
+		ImmutableTrace::Stop();
+		auto records = ImmutableTrace::Load(path);
+		ASSERT_EQ(records.size(), count * 4);
+		// records of different threads interleave, but the calls of each thread keep their order
+		unordered_map<uint32_t, vector<TraceRecord>> threads;
+		for (auto& record : records)
+			threads[record.Thread].push_back(record);
+		ASSERT_EQ(threads.size(), 2);
+		for (auto& [thread, calls] : threads)
+		{
+			ASSERT_EQ(calls.size(), count * 2);
+			for (size_t i = 0; i < calls.size(); i += 2)
+			{
+				ASSERT_EQ(calls[i].Operation, TraceOperation::Allocate);
+				ASSERT_EQ(calls[i + 1].Operation, TraceOperation::Deallocate);
+				ASSERT_EQ(calls[i + 1].Address, calls[i].Address);
+				ASSERT_LE(calls[i].Nanoseconds, calls[i + 1].Nanoseconds);
+			}
+		}
+		remove(path.c_str());
+	};
+
+	TEST(ImmutableTraceTests, CallsAfterStopResultIsNotRecorded)
+	{
+		const string path = "immutable_trace_stopped.bin";
+		ImmutableTrace::Start(path);
+		ImmutableTrace::Stop();
+		ImmutableAllocator<int>::deallocate(ImmutableAllocator<int>::allocate(1), 1);
+		ASSERT_EQ(ImmutableTrace::Load(path).size(), 0);
+		remove(path.c_str());
+	};
+
+	TEST(ImmutableTraceTests, StartTwiceResultIsError)
+	{
+		const string path = "immutable_trace_twice.bin";
+		ImmutableTrace::Start(path);
+		ASSERT_ANY_THROW(ImmutableTrace::Start(path));
+		ImmutableTrace::Stop();
+		remove(path.c_str());
+	};
+
+	TEST(ImmutableTraceTests, CorruptedTraceResultIsError)
+	{
+		const string path = "immutable_trace_corrupted.bin";
+		{
+			ofstream file(path, ios::binary | ios::trunc);
+			file << "definitely not a trace of allocator calls";
+		}
+		ASSERT_ANY_THROW(ImmutableTrace::Load(path));
+		remove(path.c_str());
+	};
+};
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	// A hash that puts every key into the same place, so that all of them collide.
+	class CollidingHash
+	{
+	public:
+		size_t operator()(int) const
+		{
+			return 42;
+		};
+	};
+
+	TEST(PersistentMapTests, PersistentMapSetResultIsOk)
+	{
+		const int count = 20000;
+		PersistentMap<int, int> values;
+		for (int i = 0; i < count; ++i) values = values.set(i, i * 2);
+		ASSERT_EQ(values.size(), count);
+		for (int i = 0; i < count; ++i) ASSERT_EQ(*values.find(i), i * 2);
+		ASSERT_EQ(values.find(count), nullptr);
+	};
+
+	TEST(PersistentMapTests, PersistentMapOldVersionsResultIsUnchanged)
+	{
+		PersistentMap<string, int> original;
+		for (int i = 0; i < 1000; ++i) original = original.set(to_string(i), i);
+		auto changed = original.set("500", -1).set("new", 1);
+		auto shortened = original.erase("500").erase("missing");
+		ASSERT_EQ(original.size(), 1000);
+		ASSERT_EQ(changed.size(), 1001);
+		ASSERT_EQ(shortened.size(), 999);
+		ASSERT_EQ(*original.find("500"), 500);
+		ASSERT_EQ(*changed.find("500"), -1);
+		ASSERT_TRUE(changed.contains("new"));
+		ASSERT_FALSE(original.contains("new"));
+		ASSERT_FALSE(shortened.contains("500"));
+		ASSERT_EQ(*shortened.find("501"), 501);
+	};
+
+	TEST(PersistentMapTests, PersistentMapEraseToEmptyResultIsOk)
+	{
+		const int count = 3000;
+		PersistentMap<int, string> values;
+		for (int i = 0; i < count; ++i) values = values.set(i, to_string(i));
+		for (int i = 0; i < count; ++i)
+		{
+			ASSERT_EQ(*values.find(i), to_string(i));
+			values = values.erase(i);
+			ASSERT_FALSE(values.contains(i));
+		}
+		ASSERT_TRUE(values.empty());
+	};
+
+	TEST(PersistentMapTests, PersistentMapCollisionsResultIsOk)
+	{
+		PersistentMap<int, int, CollidingHash> values;
+		for (int i = 0; i < 10; ++i) values = values.set(i, i);
+		values = values.set(5, 50).erase(3);
+		ASSERT_EQ(values.size(), 9);
+		ASSERT_EQ(*values.find(5), 50);
+		ASSERT_FALSE(values.contains(3));
+		ASSERT_EQ(*values.find(9), 9);
+	};
+
+	TEST(PersistentMapTests, PersistentMapChangeResultIsError)
+	{
+		auto values = PersistentMap<int, int>().set(1, 1);
+		ASSERT_ANY_THROW(*const_cast<int*>(values.find(1)) = 2);
+		ASSERT_EQ(*values.find(1), 1);
+	};
+};
\ No newline at end of file
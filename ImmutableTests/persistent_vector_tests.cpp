@@ -0,0 +1,53 @@
+#include "gtest/gtest.h"
+
+#include "../ImmutableLibrary/headers/immutable.h"
+
+namespace immutable::tests
+{
+	TEST(PersistentVectorTests, PersistentVectorPushBackResultIsOk)
+	{
+		const int count = 40000;
+		PersistentVector<int> values;
+		for (int i = 0; i < count; ++i) values = values.push_back(i);
+		ASSERT_EQ(values.size(), count);
+		for (int i = 0; i < count; ++i) ASSERT_EQ(values[i], i);
+	};
+
+	TEST(PersistentVectorTests, PersistentVectorOldVersionsResultIsUnchanged)
+	{
+		const int count = 2000;
+		PersistentVector<int> original;
+		for (int i = 0; i < count; ++i) original = original.push_back(i);
+		auto changed = original.set(1000, -1).push_back(count);
+		auto shortened = original.pop_back();
+		ASSERT_EQ(original.size(), count);
+		ASSERT_EQ(changed.size(), count + 1);
+		ASSERT_EQ(shortened.size(), count - 1);
+		ASSERT_EQ(original[1000], 1000);
+		ASSERT_EQ(changed[1000], -1);
+		ASSERT_EQ(changed[count], count);
+		for (int i = 0; i < count - 1; ++i) ASSERT_EQ(shortened[i], i);
+	};
+
+	TEST(PersistentVectorTests, PersistentVectorPopBackToEmptyResultIsOk)
+	{
+		const int count = 1100;
+		PersistentVector<string> values;
+		for (int i = 0; i < count; ++i) values = values.push_back(to_string(i));
+		for (int i = count; i > 0; --i)
+		{
+			ASSERT_EQ(values[i - 1], to_string(i - 1));
+			values = values.pop_back();
+		}
+		ASSERT_TRUE(values.empty());
+		ASSERT_ANY_THROW(values.pop_back());
+	};
+
+	TEST(PersistentVectorTests, PersistentVectorChangeResultIsError)
+	{
+		auto values = PersistentVector<int>().push_back(1).push_back(2);
+		ASSERT_ANY_THROW(const_cast<int&>(values[0]) = 3);
+		ASSERT_EQ(values[0], 1);
+		ASSERT_ANY_THROW(values.set(2, 3));
+	};
+};
\ No newline at end of file